@@ -0,0 +1,417 @@
+/*
+ * File: Bermudan.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the BermudanSolver class. Paths are only simulated on the exercise dates and stored date by
+ * date, so the regression and the policy read contiguous rows. For the dual bound the value of the policy L_k at an
+ * exercise date is h_k if the policy exercises and its continuation C_k otherwise, and the martingale is
+ *     M_k = L_k - L_0 + sum over earlier exercise dates i of (h_i - C_i).
+ * C_k is only needed where h_k > 0: out-of-the-money dates are never exercised and can be left out of the maximum
+ * (sub-optimality checking), and at the last date L = h needs no inner simulation at all. Inner paths are advanced
+ * as one compacted block and dropped as soon as they exercise.
+ * The inner simulations of all nodes of an outer path replay one recording of random numbers from its start, so the
+ * martingale increments of an outer path are estimated with common random numbers; the batches of one node read
+ * successive parts of the recording, so they never reuse each other's numbers.
+ */
+
+#include "Bermudan.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+BermudanSolver::BermudanSolver(std::shared_ptr<SDE> sde, std::shared_ptr<FDM> fdm, std::shared_ptr<RNG> rng, std::shared_ptr<Payoff> exercise,
+    double S0, double r, const std::vector<double>& dates, int steps, int degree)
+    : sde(sde), fdm(fdm), rng(rng), exercise(exercise), S0(S0), r(r), dates(dates), steps(steps), degree(degree)
+{
+    if (!sde || !fdm || !rng || !exercise)
+    {
+        throw std::invalid_argument("One or more components (SDE, FDM, RNG, Payoff) are null.");
+    }
+    if (S0 <= 0 || steps <= 0 || degree < 1 || dates.empty())
+    {
+        throw std::invalid_argument("S0, steps, regression degree and exercise dates must be positive.");
+    }
+    for (std::size_t k = 0; k < dates.size(); ++k)
+    {
+        if (dates[k] <= (k == 0 ? 0.0 : dates[k - 1]))
+        {
+            throw std::invalid_argument("Exercise dates must be positive and strictly increasing.");
+        }
+    }
+}
+
+void BermudanSolver::advance(const double* from, double* to, std::size_t n, std::size_t k, RNG& generator, double* Z) const
+{
+    double t = k == 0 ? 0.0 : dates[k - 1];
+    double dt = dates[k] - t;
+    if (sde->hasExactTransition())
+    {
+        sde->sampleTransition(from, to, n, t, dt, generator, Z); // Jump straight to the next exercise date
+        return;
+    }
+
+    std::copy(from, from + n, to);
+    std::vector<double> previous(n); // Prices before the step, for the boundary policy
+    double h = dt / steps;
+    double sqrtH = std::sqrt(h);
+    std::uint64_t fired = 0;
+    for (int s = 0; s < steps; ++s)
+    {
+        generator.generateBlock(Z, n);
+        for (std::size_t p = 0; p < n; ++p)
+        {
+            Z[p] *= sqrtH; // Scale from standard normals to Wiener increments
+        }
+        std::copy(to, to + n, previous.begin());
+        fdm->advanceBlock(previous.data(), to, n, t + s * h, h, Z);
+        fired += sde->applyBoundary(previous.data(), to, n); // Exercise values need every path, so Reject only truncates here
+    }
+    sde->countBoundary(fired, 0);
+}
+
+double BermudanSolver::continuation(std::size_t k, double S) const
+{
+    const double* beta = coefficients.data() + k * (degree + 1);
+    double x = S / S0;
+    double value = beta[degree];
+    for (int i = degree - 1; i >= 0; --i)
+    {
+        value = value * x + beta[i]; // Horner's rule
+    }
+    return value;
+}
+
+bool BermudanSolver::exercises(std::size_t k, double S, double h) const
+{
+    return h > 0 && (k + 1 == dates.size() || h >= continuation(k, S));
+}
+
+void BermudanSolver::forChunks(std::size_t chunks, std::uint64_t base, const std::function<void(std::size_t, RNG&)>& body) const
+{
+    if (!rng->stream(0))
+    {
+        for (std::size_t c = 0; c < chunks; ++c)
+        {
+            body(c, *rng); // The RNG cannot be split: run the chunks in order on this thread
+        }
+        return;
+    }
+    ThreadPool::instance().parallelFor(chunks, [&](std::size_t c)
+    {
+        std::shared_ptr<RNG> generator = rng->stream(base + c); // Each chunk draws from its own stream
+        body(c, *generator);
+    });
+}
+
+void BermudanSolver::train(int paths)
+{
+    if (paths <= 0)
+    {
+        throw std::invalid_argument("Number of training paths must be positive.");
+    }
+    std::size_t n = paths;
+    std::size_t K = dates.size();
+    std::vector<double> states(K * n); // states[k * n + p]: price of path p at dates[k]
+
+    forChunks((n + blockSize - 1) / blockSize, trainingStream, [&](std::size_t c, RNG& generator)
+    {
+        std::size_t first = c * blockSize;
+        std::size_t m = std::min(blockSize, n - first);
+        std::vector<double> start(m, S0), Z(m);
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            const double* from = k == 0 ? start.data() : &states[(k - 1) * n + first];
+            advance(from, &states[k * n + first], m, k, generator, Z.data());
+        }
+    });
+
+    std::size_t B = degree + 1; // Basis size
+    std::vector<double> cash(n); // Discounted cash flow of the policy on each path
+    double last = std::exp(-r * dates[K - 1]);
+    for (std::size_t p = 0; p < n; ++p)
+    {
+        cash[p] = last * (*exercise)(states[(K - 1) * n + p]);
+    }
+
+    coefficients.assign((K - 1) * B, 0.0);
+    std::vector<double> A(B * (B + 1)), phi(B);
+    for (std::size_t k = K - 1; k-- > 0; ) // Backward induction over the earlier dates
+    {
+        double discount = std::exp(-r * dates[k]);
+        const double* S = &states[k * n];
+        std::fill(A.begin(), A.end(), 0.0); // Normal equations [X'X | X'y] over in-the-money paths
+        std::size_t used = 0;
+        for (std::size_t p = 0; p < n; ++p)
+        {
+            if ((*exercise)(S[p]) <= 0)
+            {
+                continue; // Only in-the-money paths carry information about the exercise decision
+            }
+            double x = S[p] / S0;
+            phi[0] = 1.0;
+            for (std::size_t i = 1; i < B; ++i)
+            {
+                phi[i] = phi[i - 1] * x;
+            }
+            double y = cash[p] / discount; // Realised continuation in dates[k] money
+            for (std::size_t i = 0; i < B; ++i)
+            {
+                for (std::size_t j = 0; j < B; ++j)
+                {
+                    A[i * (B + 1) + j] += phi[i] * phi[j];
+                }
+                A[i * (B + 1) + B] += phi[i] * y;
+            }
+            ++used;
+        }
+
+        double* beta = &coefficients[k * B];
+        bool solved = used >= B;
+        for (std::size_t i = 0; solved && i < B; ++i) // Gaussian elimination with partial pivoting
+        {
+            std::size_t pivot = i;
+            for (std::size_t j = i + 1; j < B; ++j)
+            {
+                if (std::abs(A[j * (B + 1) + i]) > std::abs(A[pivot * (B + 1) + i]))
+                {
+                    pivot = j;
+                }
+            }
+            if (std::abs(A[pivot * (B + 1) + i]) < 1e-300)
+            {
+                solved = false;
+                break;
+            }
+            for (std::size_t j = 0; j <= B; ++j)
+            {
+                std::swap(A[i * (B + 1) + j], A[pivot * (B + 1) + j]);
+            }
+            for (std::size_t j = i + 1; j < B; ++j)
+            {
+                double factor = A[j * (B + 1) + i] / A[i * (B + 1) + i];
+                for (std::size_t l = i; l <= B; ++l)
+                {
+                    A[j * (B + 1) + l] -= factor * A[i * (B + 1) + l];
+                }
+            }
+        }
+        for (std::size_t i = B; solved && i-- > 0; )
+        {
+            double value = A[i * (B + 1) + B];
+            for (std::size_t j = i + 1; j < B; ++j)
+            {
+                value -= A[i * (B + 1) + j] * beta[j];
+            }
+            beta[i] = value / A[i * (B + 1) + i];
+        }
+        if (!solved)
+        {
+            std::fill(beta, beta + B, 0.0); // Too few in-the-money paths: exercise whenever in the money
+        }
+
+        for (std::size_t p = 0; p < n; ++p)
+        {
+            double h = (*exercise)(S[p]);
+            if (exercises(k, S[p], h))
+            {
+                cash[p] = discount * h; // Exercise now replaces the later cash flow
+            }
+        }
+    }
+}
+
+double BermudanSolver::lowerBound(int paths, double* error)
+{
+    if (paths <= 0)
+    {
+        throw std::invalid_argument("Number of lower-bound paths must be positive.");
+    }
+    if (coefficients.size() + degree + 1 != dates.size() * (degree + 1))
+    {
+        throw std::logic_error("Train the exercise policy before computing the lower bound.");
+    }
+
+    std::size_t n = paths;
+    std::size_t K = dates.size();
+    std::size_t chunks = (n + blockSize - 1) / blockSize;
+    std::vector<double> partial(2 * chunks); // Sum and sum of squares of each chunk
+
+    forChunks(chunks, lowerStream, [&](std::size_t c, RNG& generator)
+    {
+        std::size_t first = c * blockSize;
+        std::size_t m = std::min(blockSize, n - first);
+        std::vector<double> S(m, S0), next(m), Z(m);
+        double sum = 0.0, squares = 0.0;
+        for (std::size_t k = 0; k < K && m > 0; ++k)
+        {
+            advance(S.data(), next.data(), m, k, generator, Z.data());
+            double discount = std::exp(-r * dates[k]);
+            std::size_t alive = 0;
+            for (std::size_t p = 0; p < m; ++p)
+            {
+                double h = (*exercise)(next[p]);
+                if (exercises(k, next[p], h))
+                {
+                    sum += discount * h;
+                    squares += discount * h * discount * h;
+                }
+                else
+                {
+                    S[alive++] = next[p]; // Keep only the paths that continue
+                }
+            }
+            m = alive;
+        }
+        partial[2 * c] = sum;
+        partial[2 * c + 1] = squares;
+    });
+
+    double sum = 0.0, squares = 0.0;
+    for (std::size_t c = 0; c < chunks; ++c)
+    {
+        sum += partial[2 * c]; // Combine in chunk order so the result does not depend on scheduling
+        squares += partial[2 * c + 1];
+    }
+    double mean = sum / n;
+    if (error)
+    {
+        *error = std::sqrt(std::max(squares / n - mean * mean, 0.0) / n);
+    }
+    return mean;
+}
+
+double BermudanSolver::innerValue(std::size_t k, double S, RNG& replay, int minPaths, int maxPaths, double tolerance, int& used) const
+{
+    std::size_t K = dates.size();
+    std::vector<double> from(maxPaths), to(maxPaths), Z(maxPaths);
+    double sum = 0.0, squares = 0.0;
+    int n = 0;
+    int batch = minPaths;
+
+    while (true)
+    {
+        std::size_t m = std::min(batch, maxPaths - n);
+        std::fill(from.begin(), from.begin() + m, S); // Every inner path starts from the outer state
+        for (std::size_t j = k + 1; j < K && m > 0; ++j)
+        {
+            advance(from.data(), to.data(), m, j, replay, Z.data());
+            double discount = std::exp(-r * dates[j]);
+            std::size_t alive = 0;
+            for (std::size_t p = 0; p < m; ++p)
+            {
+                double h = (*exercise)(to[p]);
+                if (exercises(j, to[p], h))
+                {
+                    sum += discount * h;
+                    squares += discount * h * discount * h;
+                }
+                else
+                {
+                    from[alive++] = to[p]; // Exercised inner paths stop here
+                }
+            }
+            m = alive;
+        }
+        n += std::min(batch, maxPaths - n);
+
+        double mean = sum / n;
+        double stderror = std::sqrt(std::max(squares / n - mean * mean, 0.0) / n);
+        if (n >= maxPaths || stderror <= tolerance * mean)
+        {
+            used += n;
+            return mean;
+        }
+        batch = n; // Double the inner budget until the estimate is precise enough
+    }
+}
+
+DualBounds BermudanSolver::solve(int trainingPaths, int lowerPaths, int outerPaths, int minInnerPaths, int maxInnerPaths, double tolerance)
+{
+    if (outerPaths <= 0 || minInnerPaths <= 0 || maxInnerPaths < minInnerPaths || tolerance < 0)
+    {
+        throw std::invalid_argument("Outer and inner path counts must be positive, with maxInnerPaths >= minInnerPaths.");
+    }
+
+    DualBounds bounds{};
+    train(trainingPaths);
+    bounds.lower = lowerBound(lowerPaths, &bounds.lowerError);
+
+    std::size_t n = outerPaths;
+    std::size_t K = dates.size();
+    std::size_t chunks = (n + outerChunk - 1) / outerChunk;
+    std::vector<double> partial(4 * chunks); // Sum and sum of squares of the dual terms, nodes and inner paths of each chunk
+
+    forChunks(chunks, outerStream, [&](std::size_t c, RNG& generator)
+    {
+        std::size_t first = c * outerChunk;
+        std::size_t m = std::min(outerChunk, n - first);
+        std::vector<double> states(K * m), start(m, S0), Z(m);
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            advance(k == 0 ? start.data() : &states[(k - 1) * m], &states[k * m], m, k, generator, Z.data());
+        }
+
+        std::size_t perPath = sde->hasExactTransition() ? 1 : steps; // Normals per inner path and exercise date (more for jump models)
+        ReplayRNG replay(static_cast<std::size_t>(maxInnerPaths) * (K - 1) * perPath); // Common random numbers for every node of an outer path
+        double sum = 0.0, squares = 0.0, nodes = 0.0, inner = 0.0;
+        for (std::size_t p = 0; p < m; ++p)
+        {
+            replay.refill(generator);
+            double martingale = 0.0; // Sum of h_i - C_i over earlier exercise dates
+            double best = -std::numeric_limits<double>::infinity();
+            for (std::size_t k = 0; k < K; ++k)
+            {
+                if (k + 1 == K)
+                {
+                    best = std::max(best, -martingale); // At maturity L = h, so h - M needs no inner simulation
+                    break;
+                }
+                double S = states[k * m + p];
+                double h = (*exercise)(S);
+                if (h <= 0)
+                {
+                    continue; // Out of the money: never exercised, so the date cannot raise the bound
+                }
+
+                int used = 0;
+                replay.rewind(); // Every node of the outer path reads the same numbers from the start
+                double C = innerValue(k, S, replay, minInnerPaths, maxInnerPaths, tolerance, used);
+                nodes += 1.0;
+                inner += used;
+
+                double discounted = std::exp(-r * dates[k]) * h;
+                bool exercised = exercises(k, S, h);
+                double L = exercised ? discounted : C;
+                best = std::max(best, discounted - L - martingale);
+                if (exercised)
+                {
+                    martingale += discounted - C;
+                }
+            }
+            sum += best;
+            squares += best * best;
+        }
+        partial[4 * c] = sum;
+        partial[4 * c + 1] = squares;
+        partial[4 * c + 2] = nodes;
+        partial[4 * c + 3] = inner;
+    });
+
+    double sum = 0.0, squares = 0.0, nodes = 0.0, inner = 0.0;
+    for (std::size_t c = 0; c < chunks; ++c)
+    {
+        sum += partial[4 * c]; // Combine in chunk order so the result does not depend on scheduling
+        squares += partial[4 * c + 1];
+        nodes += partial[4 * c + 2];
+        inner += partial[4 * c + 3];
+    }
+    double gap = sum / n; // Duality gap: upper minus lower bound
+    double gapVariance = std::max(squares / n - gap * gap, 0.0) / n;
+    bounds.upper = bounds.lower + gap;
+    bounds.upperError = std::sqrt(gapVariance + bounds.lowerError * bounds.lowerError);
+    bounds.innerPaths = nodes > 0 ? inner / nodes : 0.0;
+    return bounds;
+}
\ No newline at end of file
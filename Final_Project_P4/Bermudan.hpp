@@ -0,0 +1,78 @@
+/*
+ * File: Bermudan.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the BermudanSolver class, which brackets the price of a Bermudan option between a lower and an
+ * upper bound. The lower bound follows the Longstaff-Schwartz exercise policy: continuation values are regressed on
+ * powers of the asset price over a set of training paths, and the policy is then applied to fresh paths. The upper
+ * bound is the Andersen-Broadie dual: along every outer path the martingale part of the policy's value process is
+ * estimated by nested inner simulations launched from the outer states, and the bound is the mean of the largest
+ * exercise value net of that martingale. Inner simulations are skipped where the decision is clear (out of the
+ * money), stop as soon as every inner path has exercised, replay one recording of random numbers at every node of
+ * an outer path, and grow in batches only until their standard error meets the requested tolerance. Outer paths run
+ * in parallel chunks.
+ * Prices are discounted at the rate r; the exercise value is given by any Payoff through its operator()(double).
+ */
+
+#ifndef BERMUDAN_HPP
+#define BERMUDAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "SDE.hpp"
+#include "FDM.hpp"
+#include "RNG.hpp"
+#include "Payoff.hpp"
+
+struct DualBounds
+{
+    double lower; // Longstaff-Schwartz lower bound
+    double lowerError; // Standard error of the lower bound
+    double upper; // Andersen-Broadie upper bound
+    double upperError; // Standard error of the upper bound
+    double innerPaths; // Average number of inner paths per simulated node
+};
+
+class BermudanSolver
+{
+private:
+    std::shared_ptr<SDE> sde; // Model of the underlying
+    std::shared_ptr<FDM> fdm; // Scheme used between exercise dates when the model has no exact transition
+    std::shared_ptr<RNG> rng; // Random Number Generator
+    std::shared_ptr<Payoff> exercise; // Exercise value h(S)
+    double S0; // Initial stock price
+    double r; // Discount rate
+    std::vector<double> dates; // Exercise dates (increasing, the last one is the maturity)
+    int steps; // FDM steps between consecutive exercise dates
+    int degree; // Degree of the regression polynomial
+    std::vector<double> coefficients; // Regression coefficients of the continuation value at every date but the last
+
+    void advance(const double* from, double* to, std::size_t n, std::size_t k, RNG& generator, double* Z) const; // Move n states to dates[k]
+    double continuation(std::size_t k, double S) const; // Regressed continuation value at dates[k], in dates[k] money
+    bool exercises(std::size_t k, double S, double h) const; // Policy decision at dates[k] given h = h(S)
+    double innerValue(std::size_t k, double S, RNG& replay, int minPaths, int maxPaths, double tolerance, int& used) const; // Policy value from dates[k] on, time-0 money
+    void forChunks(std::size_t chunks, std::uint64_t base, const std::function<void(std::size_t, RNG&)>& body) const; // Run chunks in parallel on their own streams when possible
+
+public:
+    static constexpr std::size_t blockSize = 256; // Paths simulated together
+    static constexpr std::size_t outerChunk = 16; // Outer paths per parallel task
+    static constexpr std::uint64_t trainingStream = std::uint64_t(1) << 40; // First RNG stream of the training paths
+    static constexpr std::uint64_t lowerStream = std::uint64_t(2) << 40; // First RNG stream of the lower-bound paths
+    static constexpr std::uint64_t outerStream = std::uint64_t(3) << 40; // First RNG stream of the outer paths
+
+    BermudanSolver(std::shared_ptr<SDE> sde, std::shared_ptr<FDM> fdm, std::shared_ptr<RNG> rng, std::shared_ptr<Payoff> exercise,
+        double S0, double r, const std::vector<double>& dates, int steps = 1, int degree = 3); // Constructor
+
+    void train(int paths); // Fit the Longstaff-Schwartz policy on paths training paths
+    double lowerBound(int paths, double* error = nullptr); // Value of the policy on fresh paths
+    DualBounds solve(int trainingPaths, int lowerPaths, int outerPaths, int minInnerPaths = 64, int maxInnerPaths = 1024,
+        double tolerance = 0.01); // Train, then compute both bounds
+};
+
+#endif // BERMUDAN_HPP
\ No newline at end of file
@@ -0,0 +1,129 @@
+/*
+ * File: Dispatch.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the instruction set detection and the selection of the active KernelTable. A feature is
+ * only usable if the processor reports it through CPUID and the operating system saves the matching registers on
+ * a context switch (XGETBV), so a processor with AVX-512 under an OS that does not save the 512-bit state falls back
+ * to AVX2. Detection runs once; afterwards every kernels() call is a single atomic load.
+ */
+
+#include "Dispatch.hpp"
+#include <atomic>
+
+#if defined(MC_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+static void cpuid(unsigned leaf, unsigned subleaf, unsigned registers[4])
+{
+#if defined(_MSC_VER)
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i)
+    {
+        registers[i] = static_cast<unsigned>(values[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+static std::uint64_t savedStates()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned low, high;
+    __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0)); // XCR0: register states the OS saves
+    return (static_cast<std::uint64_t>(high) << 32) | low;
+#endif
+}
+#endif
+
+Isa detectIsa()
+{
+#if defined(MC_X86)
+    unsigned registers[4]; // EAX, EBX, ECX, EDX
+    cpuid(0, 0, registers);
+    unsigned maxLeaf = registers[0];
+    cpuid(1, 0, registers);
+    bool osxsave = registers[2] & (1u << 27), avx = registers[2] & (1u << 28), fma = registers[2] & (1u << 12);
+    if (!osxsave || !avx || maxLeaf < 7)
+    {
+        return Isa::SSE2;
+    }
+
+    std::uint64_t states = savedStates();
+    cpuid(7, 0, registers);
+    bool avx2 = registers[1] & (1u << 5);
+    bool avx512 = (registers[1] & (1u << 16)) && (registers[1] & (1u << 17)); // AVX-512 F and DQ
+    if (avx512 && (states & 0xE6) == 0xE6) // SSE, AVX, opmask and both halves of the upper ZMM state
+    {
+        return Isa::AVX512;
+    }
+    if (avx2 && fma && (states & 0x6) == 0x6) // SSE and AVX state
+    {
+        return Isa::AVX2;
+    }
+    return Isa::SSE2;
+#else
+    return Isa::Portable;
+#endif
+}
+
+static const KernelTable* tableFor(Isa isa)
+{
+    switch (isa)
+    {
+    case Isa::AVX512:
+        return avx512Kernels();
+    case Isa::AVX2:
+        return avx2Kernels();
+    default:
+        return baselineKernels()->isa == isa ? baselineKernels() : nullptr;
+    }
+}
+
+bool isaSupported(Isa isa)
+{
+    return tableFor(isa) && isa <= detectIsa(); // Each level implies the ones below it
+}
+
+std::vector<Isa> supportedIsas()
+{
+    std::vector<Isa> isas;
+    for (Isa isa : { Isa::Portable, Isa::SSE2, Isa::AVX2, Isa::AVX512 })
+    {
+        if (isaSupported(isa))
+        {
+            isas.push_back(isa);
+        }
+    }
+    return isas;
+}
+
+static std::atomic<const KernelTable*>& activeTable()
+{
+    static std::atomic<const KernelTable*> active{ tableFor(supportedIsas().back()) }; // Detected once, on first use
+    return active;
+}
+
+const KernelTable& kernels()
+{
+    return *activeTable().load(std::memory_order_acquire);
+}
+
+void selectKernels(Isa isa)
+{
+    if (!isaSupported(isa))
+    {
+        throw std::invalid_argument("The requested instruction set is not supported on this host.");
+    }
+    activeTable().store(tableFor(isa), std::memory_order_release);
+}
\ No newline at end of file
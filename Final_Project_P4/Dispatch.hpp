@@ -0,0 +1,88 @@
+/*
+ * File: Dispatch.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the runtime CPU dispatch of the batch kernels. The hot loops of the engine (the block step of
+ * every scheme for the batch models, the boundary policies, Wiener increment scaling, inverse Gaussian sampling and
+ * the terminal and barrier payoffs, and the backward induction of the lattice) are written once in Kernels.inl, on the vector types of Simd.hpp, and compiled into one KernelTable per instruction set: the baseline
+ * (SSE2 on x86), AVX2 with FMA, and AVX-512. CPUID and the operating system's saved register state are checked
+ * once, on first use, and kernels() then returns the table of the widest instruction set the host supports, so one
+ * binary runs its best code on every machine of a mixed fleet. selectKernels() forces a narrower table, for
+ * benchmarks and for comparing results across instruction sets. The kernel files are compiled without floating-point
+ * contraction (KernelsPrologue.hpp), so the tables round exactly the same operations and a seeded simulation prices bit for bit the same
+ * on every table.
+ */
+
+#ifndef DISPATCH_HPP
+#define DISPATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MC_X86 1 // The AVX2 and AVX-512 tables are only built for x86 targets
+#endif
+
+enum class Isa
+{
+    Portable, // Baseline table on non-x86 targets
+    SSE2,     // Baseline table on x86 (every x86-64 processor)
+    AVX2,     // 256-bit vectors with fused multiply-add
+    AVX512    // 512-bit vectors
+};
+
+enum class BatchModel // SDEs whose Kernel template is compiled into the step kernels of every table
+{
+    GBM,
+    CEV,
+    CIR
+};
+
+constexpr std::size_t batchModels = 3; // Number of BatchModel values
+constexpr std::size_t maxBatchParameters = 4; // Largest parameter count of a batch model
+
+// One step of n paths of a batch model with the given parameters
+using StepKernel = void (*)(const double* parameters, const double* S, double* out, std::size_t n, double t, double dt, const double* dW);
+
+struct KernelTable
+{
+    Isa isa; // Instruction set the table was compiled for
+    const char* name; // Printable name of the instruction set
+
+    StepKernel euler[batchModels]; // Scheme steps, indexed by BatchModel
+    StepKernel milstein[batchModels];
+    StepKernel predictorCorrector[batchModels];
+    std::size_t (*absorb)(const double* previous, double* next, std::size_t n); // Boundary policies, each returning
+    std::size_t (*reflect)(double* next, std::size_t n);                       // the number of prices that were below zero
+    std::size_t (*truncate)(double* next, std::size_t n);
+    std::size_t (*reject)(double* next, std::uint8_t* rejected, std::size_t n);
+    void (*scale)(double* x, std::size_t n, double factor); // x *= factor
+    void (*affine)(double* x, std::size_t n, double factor, double shift); // x = factor x + shift
+    // Michael-Schucany-Haas inverse Gaussian samples from n normals and n uniforms
+    void (*inverseGaussian)(const double* normals, const double* uniforms, double* out, std::size_t n, double mean, double shape);
+    void (*callPayoff)(const double* S, double* out, std::size_t n, double K); // out = max(S - K, 0)
+    void (*putPayoff)(const double* S, double* out, std::size_t n, double K); // out = max(K - S, 0)
+    void (*runningMax)(double* extreme, const double* row, std::size_t n); // extreme = max(extreme, row)
+    void (*runningMin)(double* extreme, const double* row, std::size_t n); // extreme = min(extreme, row)
+    // Barrier payoffs from terminal prices and running extremes, written over the extremes
+    void (*barrierSettle)(const double* ST, double* extreme, std::size_t n, double K, double B, bool isCall, bool isUp, bool isIn);
+    // One step back through a rolling lattice row, in place; the weights include the discount factor
+    void (*binomialStep)(double* V, std::size_t n, double down, double up); // V[k] = down V[k] + up V[k + 1]
+    void (*trinomialStep)(double* V, std::size_t n, double down, double middle, double up); // V[k] = down V[k] + middle V[k + 1] + up V[k + 2]
+};
+
+const KernelTable* baselineKernels(); // Defined by KernelsSSE2.cpp, always available
+const KernelTable* avx2Kernels(); // Defined by KernelsAVX2.cpp, null if not built for this target
+const KernelTable* avx512Kernels(); // Defined by KernelsAVX512.cpp, null if not built for this target
+
+Isa detectIsa(); // Widest instruction set supported by both the processor and the operating system
+bool isaSupported(Isa isa); // True if a table for isa is built and the host can run it
+std::vector<Isa> supportedIsas(); // Every runnable instruction set, narrowest first
+const KernelTable& kernels(); // Active table (the widest runnable one unless selectKernels() chose another)
+void selectKernels(Isa isa); // Switch the active table; throws if the host cannot run it
+
+#endif // DISPATCH_HPP
\ No newline at end of file
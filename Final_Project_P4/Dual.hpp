@@ -0,0 +1,143 @@
+/*
+ * File: Dual.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the Dual class template, a forward-mode automatic differentiation scalar. A Dual<K> carries a
+ * value and K tangents in a fixed-size array, so one evaluation propagates K directional derivatives at once with
+ * no tape and no heap memory; every operation is a short fixed-length loop over the tangents that the compiler
+ * unrolls and vectorizes. The SDE kernels, FDM steps and payoffs are written as templates over the scalar type, so
+ * they compile unchanged against double and against Dual<K>.
+ */
+
+#ifndef DUAL_HPP
+#define DUAL_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+template <std::size_t K>
+class Dual
+{
+public:
+    double value; // Value of the quantity
+    std::array<double, K> tangent; // Derivatives along K seeded directions
+
+    Dual(double value = 0.0) : value(value), tangent{} {} // A constant: every tangent is zero
+
+    static Dual variable(double value, std::size_t lane) // An input differentiated along lane
+    {
+        Dual x(value);
+        x.tangent[lane] = 1.0;
+        return x;
+    }
+
+    Dual& operator+=(const Dual& y)
+    {
+        value += y.value;
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            tangent[k] += y.tangent[k];
+        }
+        return *this;
+    }
+
+    Dual& operator-=(const Dual& y)
+    {
+        value -= y.value;
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            tangent[k] -= y.tangent[k];
+        }
+        return *this;
+    }
+
+    Dual& operator*=(const Dual& y)
+    {
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            tangent[k] = tangent[k] * y.value + value * y.tangent[k]; // Product rule
+        }
+        value *= y.value;
+        return *this;
+    }
+
+    Dual& operator/=(const Dual& y)
+    {
+        double inverse = 1.0 / y.value;
+        value *= inverse;
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            tangent[k] = (tangent[k] - value * y.tangent[k]) * inverse; // Quotient rule
+        }
+        return *this;
+    }
+
+    Dual operator-() const
+    {
+        Dual x(*this);
+        x.value = -value;
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            x.tangent[k] = -tangent[k];
+        }
+        return x;
+    }
+};
+
+template <std::size_t K> Dual<K> operator+(Dual<K> x, const Dual<K>& y) { return x += y; }
+template <std::size_t K> Dual<K> operator-(Dual<K> x, const Dual<K>& y) { return x -= y; }
+template <std::size_t K> Dual<K> operator*(Dual<K> x, const Dual<K>& y) { return x *= y; }
+template <std::size_t K> Dual<K> operator/(Dual<K> x, const Dual<K>& y) { return x /= y; }
+
+template <std::size_t K> Dual<K> operator+(Dual<K> x, double y) { x.value += y; return x; }
+template <std::size_t K> Dual<K> operator+(double x, Dual<K> y) { y.value += x; return y; }
+template <std::size_t K> Dual<K> operator-(Dual<K> x, double y) { x.value -= y; return x; }
+template <std::size_t K> Dual<K> operator-(double x, const Dual<K>& y) { Dual<K> z = -y; z.value += x; return z; }
+template <std::size_t K> Dual<K> operator/(const Dual<K>& x, double y) { return x * (1.0 / y); }
+template <std::size_t K> Dual<K> operator/(double x, const Dual<K>& y) { return Dual<K>(x) / y; }
+
+template <std::size_t K>
+Dual<K> operator*(Dual<K> x, double y)
+{
+    x.value *= y;
+    for (std::size_t k = 0; k < K; ++k)
+    {
+        x.tangent[k] *= y;
+    }
+    return x;
+}
+
+template <std::size_t K> Dual<K> operator*(double x, const Dual<K>& y) { return y * x; }
+
+// Comparisons look at values only: branches pick a formula, and the tangents follow the chosen one
+template <std::size_t K> bool operator<(const Dual<K>& x, const Dual<K>& y) { return x.value < y.value; }
+template <std::size_t K> bool operator>(const Dual<K>& x, const Dual<K>& y) { return x.value > y.value; }
+template <std::size_t K> bool operator<(const Dual<K>& x, double y) { return x.value < y; }
+template <std::size_t K> bool operator>(const Dual<K>& x, double y) { return x.value > y; }
+template <std::size_t K> bool operator<(double x, const Dual<K>& y) { return x < y.value; }
+template <std::size_t K> bool operator>(double x, const Dual<K>& y) { return x > y.value; }
+
+template <std::size_t K>
+Dual<K> chain(const Dual<K>& x, double value, double derivative) // f(x) given f(x.value) and f'(x.value)
+{
+    Dual<K> y(value);
+    for (std::size_t k = 0; k < K; ++k)
+    {
+        y.tangent[k] = derivative * x.tangent[k];
+    }
+    return y;
+}
+
+template <std::size_t K> Dual<K> exp(const Dual<K>& x) { double e = std::exp(x.value); return chain(x, e, e); }
+template <std::size_t K> Dual<K> log(const Dual<K>& x) { return chain(x, std::log(x.value), 1.0 / x.value); }
+template <std::size_t K> Dual<K> sqrt(const Dual<K>& x) { double s = std::sqrt(x.value); return chain(x, s, 0.5 / s); }
+template <std::size_t K> Dual<K> pow(const Dual<K>& x, double p) { double v = std::pow(x.value, p); return chain(x, v, p * v / x.value); }
+template <std::size_t K> Dual<K> pow(const Dual<K>& x, const Dual<K>& p) { return exp(p * log(x)); }
+
+inline double valueOf(double x) { return x; } // Value of a plain or dual scalar
+template <std::size_t K> double valueOf(const Dual<K>& x) { return x.value; }
+
+#endif // DUAL_HPP
\ No newline at end of file
@@ -8,9 +8,59 @@
  * for the Euler, Milstein, and Drift-Adjusted Predictor-Corrector methods for advancing the solution of an SDE.
  * Each method takes the current state of the system (S), time (t), time step (dt), and Wiener process increment (dW)
  * to compute the next state of the system. These methods are essential for numerical simulations in quantitative finance.
+ * For the batch models (GBM, CEV, CIR) whole rows are stepped by the runtime-dispatched KernelTable, which runs the same
+ * step templates over SIMD vectors; other SDEs take one virtual call per path.
  */
 
 #include "FDM.hpp"
+#include "Dispatch.hpp"
+#include <cmath>
+
+void FDM::advanceBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* dW)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        out[i] = advance(S[i], t, dt, dW[i]); // Default: apply the scalar scheme to every path
+    }
+}
+
+std::string FDM::key() const
+{
+    return ""; // Unknown schemes are only identified by their address
+}
+
+std::shared_ptr<SDE> FDM::model() const
+{
+    return nullptr; // Unknown schemes leave their output as it is
+}
+
+bool FDM::samplesDates() const
+{
+    return false; // A discretisation is only accurate on the grid it was asked to step
+}
+
+// Step a row with the dispatched kernel of the scheme family if the SDE is a batch model; false if it is not
+static bool batchStep(const StepKernel* family, const SDE& sde, const double* S, double* out, std::size_t n, double t, double dt, const double* dW)
+{
+    BatchModel model;
+    double parameters[maxBatchParameters];
+    if (dt <= 0 || !sde.batchModel(model, parameters))
+    {
+        return false; // Invalid steps go through advance(), which reports them
+    }
+    family[static_cast<std::size_t>(model)](parameters, S, out, n, t, dt, dW);
+    return true;
+}
+
+static std::string schemeKey(const char* name, const std::shared_ptr<SDE>& sde)
+{
+    std::string sdeKey = sde->key();
+    if (sdeKey.empty())
+    {
+        return ""; // Unknown SDE makes the scheme unknown too
+    }
+    return std::string(name) + "[" + sdeKey + "]/" + std::to_string(static_cast<int>(sde->boundary())); // Paths differ by boundary policy
+}
 
 EulerMethod::EulerMethod(std::shared_ptr<SDE> sde) : sde(sde)
 {
@@ -26,7 +76,25 @@ double EulerMethod::advance(double S, double t, double dt, double dW)
     {
         throw std::invalid_argument("Time step (dt) must be positive.");
     }
-    return S + sde->drift(S, t) * dt + sde->diffusion(S, t) * dW; // Euler method formula
+    return step(*sde, S, t, dt, dW); // Euler method formula
+}
+
+void EulerMethod::advanceBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* dW)
+{
+    if (!batchStep(kernels().euler, *sde, S, out, n, t, dt, dW))
+    {
+        FDM::advanceBlock(S, out, n, t, dt, dW);
+    }
+}
+
+std::string EulerMethod::key() const
+{
+    return schemeKey("Euler", sde);
+}
+
+std::shared_ptr<SDE> EulerMethod::model() const
+{
+    return sde;
 }
 
 MilsteinMethod::MilsteinMethod(std::shared_ptr<SDE> sde) : sde(sde)
@@ -43,11 +111,25 @@ double MilsteinMethod::advance(double S, double t, double dt, double dW)
     {
         throw std::invalid_argument("Time step (dt) must be positive.");
     }
-    double drift = sde->drift(S, t); // Compute drift term
-    double diffusion = sde->diffusion(S, t); // Compute diffusion term
-    double diffusionDerivative = (sde->diffusion(S + 1e-5, t) - sde->diffusion(S, t)) / 1e-5; // Approximate derivative of diffusion term
+    return step(*sde, S, t, dt, dW); // Milstein method formula
+}
+
+void MilsteinMethod::advanceBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* dW)
+{
+    if (!batchStep(kernels().milstein, *sde, S, out, n, t, dt, dW))
+    {
+        FDM::advanceBlock(S, out, n, t, dt, dW);
+    }
+}
+
+std::string MilsteinMethod::key() const
+{
+    return schemeKey("Milstein", sde);
+}
 
-    return S + drift * dt + diffusion * dW + 0.5 * diffusion * diffusionDerivative * (dW * dW - dt); // Milstein method formula
+std::shared_ptr<SDE> MilsteinMethod::model() const
+{
+    return sde;
 }
 
 DriftAdjustedPredictorCorrector::DriftAdjustedPredictorCorrector(std::shared_ptr<SDE> sde) : sde(sde)
@@ -64,15 +146,76 @@ double DriftAdjustedPredictorCorrector::advance(double S, double t, double dt, d
     {
         throw std::invalid_argument("Time step (dt) must be positive.");
     }
-    double drift = sde->drift(S, t); // Compute drift term
-    double diffusion = sde->diffusion(S, t); // Compute diffusion term
+    return step(*sde, S, t, dt, dW); // Predictor-corrector formula
+}
+
+void DriftAdjustedPredictorCorrector::advanceBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* dW)
+{
+    if (!batchStep(kernels().predictorCorrector, *sde, S, out, n, t, dt, dW))
+    {
+        FDM::advanceBlock(S, out, n, t, dt, dW);
+    }
+}
+
+std::string DriftAdjustedPredictorCorrector::key() const
+{
+    return schemeKey("PredictorCorrector", sde);
+}
 
-    // Predictor step
-    double S_predictor = S + drift * dt + diffusion * dW; // Predict the next state
+std::shared_ptr<SDE> DriftAdjustedPredictorCorrector::model() const
+{
+    return sde;
+}
 
-    // Corrector step
-    double drift_corrector = sde->drift(S_predictor, t + dt); // Compute drift at predicted state
-    double S_corrected = S + 0.5 * (drift + drift_corrector) * dt + diffusion * dW; // Correct the state using average drift
+ExactTransition::ExactTransition(std::shared_ptr<SDE> sde) : sde(sde)
+{
+    if (!sde)
+    {
+        throw std::invalid_argument("SDE pointer is null in ExactTransition constructor.");
+    }
+    if (!sde->hasExactTransition())
+    {
+        throw std::invalid_argument("SDE has no exact transition law; choose a discretisation scheme.");
+    }
+}
 
-    return S_corrected; // Return the corrected state
+double ExactTransition::advance(double S, double t, double dt, double dW)
+{
+    if (dt <= 0)
+    {
+        throw std::invalid_argument("Time step (dt) must be positive.");
+    }
+    double Z = dW / std::sqrt(dt);
+    double out;
+    sde->transitionBlock(&S, &out, 1, t, dt, &Z);
+    return out;
+}
+
+void ExactTransition::advanceBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* dW)
+{
+    if (dt <= 0)
+    {
+        throw std::invalid_argument("Time step (dt) must be positive.");
+    }
+    double scale = 1.0 / std::sqrt(dt);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        out[i] = dW[i] * scale; // Standard normals, held in out: transitions map each path on its own
+    }
+    sde->transitionBlock(S, out, n, t, dt, out);
+}
+
+std::string ExactTransition::key() const
+{
+    return schemeKey("Exact", sde);
+}
+
+std::shared_ptr<SDE> ExactTransition::model() const
+{
+    return sde;
+}
+
+bool ExactTransition::samplesDates() const
+{
+    return true;
 }
\ No newline at end of file
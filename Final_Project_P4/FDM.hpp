@@ -9,6 +9,12 @@
  * Three derived classes are implemented: EulerMethod, MilsteinMethod, and DriftAdjustedPredictorCorrector, each providing
  * a specific numerical method for advancing the solution. These methods are commonly used in financial mathematics
  * for simulating asset price paths under stochastic models.
+ * ExactTransition is the scheme to choose for a model with an exact transition law: every step is sampled from that
+ * law, and it is the only scheme with which the Monte Carlo solver may skip the grid and sample just the dates the
+ * payoffs observe. Any other scheme is always stepped through all N steps.
+ * Each scheme writes its update once as a static step() template over the model and the scalar type: advance()
+ * applies it to the virtual SDE in double precision, the forward-mode Greeks engine applies it to an SDE
+ * Kernel over Dual numbers, and the batch kernels apply it to an SDE Kernel over SIMD vectors of paths.
  */
 
 #ifndef FDM_HPP
@@ -16,6 +22,8 @@
 
 #include <memory>
 #include <stdexcept>
+#include <cstddef>
+#include <string>
 #include "SDE.hpp"
 
 class FDM
@@ -23,6 +31,10 @@ class FDM
 public:
     virtual ~FDM() = default;
     virtual double advance(double S, double t, double dt, double dW) = 0; // Advance the solution
+    virtual void advanceBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* dW); // Advance n paths by one step
+    virtual std::string key() const; // Exact description of the scheme and its SDE (empty if unknown)
+    virtual std::shared_ptr<SDE> model() const; // SDE being stepped, whose boundary policy applies (null if unknown)
+    virtual bool samplesDates() const; // True if paths may be sampled on the payoffs' observation dates only
 };
 
 class EulerMethod : public FDM
@@ -32,7 +44,12 @@ private:
 
 public:
     EulerMethod(std::shared_ptr<SDE> sde);
+    template <typename Model, typename Real, typename Noise>
+    static Real step(Model& model, const Real& S, double t, double dt, const Noise& dW); // Euler update for any model and scalar type
     double advance(double S, double t, double dt, double dW) override; // Implement Euler method
+    void advanceBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* dW) override; // Batch kernel for linear SDEs
+    std::string key() const override; // Scheme name and SDE key
+    std::shared_ptr<SDE> model() const override; // The SDE being stepped
 };
 
 class MilsteinMethod : public FDM
@@ -42,7 +59,12 @@ private:
 
 public:
     MilsteinMethod(std::shared_ptr<SDE> sde);
+    template <typename Model, typename Real, typename Noise>
+    static Real step(Model& model, const Real& S, double t, double dt, const Noise& dW); // Milstein update for any model and scalar type
     double advance(double S, double t, double dt, double dW) override; // Implement Milstein method
+    void advanceBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* dW) override; // Batch kernel for linear SDEs
+    std::string key() const override; // Scheme name and SDE key
+    std::shared_ptr<SDE> model() const override; // The SDE being stepped
 };
 
 class DriftAdjustedPredictorCorrector : public FDM
@@ -52,7 +74,56 @@ private:
 
 public:
     DriftAdjustedPredictorCorrector(std::shared_ptr<SDE> sde);
+    template <typename Model, typename Real, typename Noise>
+    static Real step(Model& model, const Real& S, double t, double dt, const Noise& dW); // Predictor-corrector update for any model and scalar type
     double advance(double S, double t, double dt, double dW) override; // Implement predictor-corrector method
+    void advanceBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* dW) override; // Batch kernel for linear SDEs
+    std::string key() const override; // Scheme name and SDE key
+    std::shared_ptr<SDE> model() const override; // The SDE being stepped
 };
 
+class ExactTransition : public FDM
+{
+private:
+    std::shared_ptr<SDE> sde; // Shared pointer to the SDE object (with an exact transition law)
+
+public:
+    ExactTransition(std::shared_ptr<SDE> sde);
+    double advance(double S, double t, double dt, double dW) override; // Sample the exact law with Z = dW / sqrt(dt)
+    void advanceBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* dW) override; // Exact law for a row
+    std::string key() const override; // Scheme name and SDE key
+    std::shared_ptr<SDE> model() const override; // The SDE being sampled
+    bool samplesDates() const override; // True: exact steps may be as large as the gaps between observation dates
+};
+
+template <typename Model, typename Real, typename Noise>
+Real EulerMethod::step(Model& model, const Real& S, double t, double dt, const Noise& dW)
+{
+    return S + model.drift(S, t) * dt + model.diffusion(S, t) * dW; // Euler method formula
+}
+
+template <typename Model, typename Real, typename Noise>
+Real MilsteinMethod::step(Model& model, const Real& S, double t, double dt, const Noise& dW)
+{
+    Real drift = model.drift(S, t); // Compute drift term
+    Real diffusion = model.diffusion(S, t); // Compute diffusion term
+    Real diffusionDerivative = (model.diffusion(S + 1e-5, t) - diffusion) / 1e-5; // Approximate derivative of diffusion term
+
+    return S + drift * dt + diffusion * dW + 0.5 * diffusion * diffusionDerivative * (dW * dW - dt); // Milstein method formula
+}
+
+template <typename Model, typename Real, typename Noise>
+Real DriftAdjustedPredictorCorrector::step(Model& model, const Real& S, double t, double dt, const Noise& dW)
+{
+    Real drift = model.drift(S, t); // Compute drift term
+    Real diffusion = model.diffusion(S, t); // Compute diffusion term
+
+    // Predictor step
+    Real S_predictor = S + drift * dt + diffusion * dW; // Predict the next state
+
+    // Corrector step
+    Real drift_corrector = model.drift(S_predictor, t + dt); // Compute drift at predicted state
+    return S + 0.5 * (drift + drift_corrector) * dt + diffusion * dW; // Correct the state using average drift
+}
+
 #endif // FDM_HPP
\ No newline at end of file
@@ -0,0 +1,100 @@
+/*
+ * File: FFT.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the FFT class with the classic iterative Cooley-Tukey algorithm: a bit-reversal permutation
+ * followed by log2(n) passes of butterflies. The inverse transform uses conjugated twiddles and divides by n.
+ */
+
+#include "FFT.hpp"
+#include <cmath>
+#include <utility>
+
+FFT::FFT(std::size_t size) : n(size), twiddles(size / 2), reversed(size)
+{
+    if (size == 0 || (size & (size - 1)) != 0)
+    {
+        throw std::invalid_argument("FFT size must be a power of two.");
+    }
+
+    const double pi = std::acos(-1.0);
+    for (std::size_t k = 0; k < n / 2; ++k)
+    {
+        twiddles[k] = std::polar(1.0, -2.0 * pi * k / n);
+    }
+
+    std::size_t bits = 0;
+    while ((std::size_t(1) << bits) < n)
+    {
+        ++bits;
+    }
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        std::size_t r = 0;
+        for (std::size_t b = 0; b < bits; ++b)
+        {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        reversed[i] = r;
+    }
+}
+
+std::size_t FFT::nextPowerOfTwo(std::size_t m)
+{
+    std::size_t p = 1;
+    while (p < m)
+    {
+        p <<= 1;
+    }
+    return p;
+}
+
+std::size_t FFT::size() const
+{
+    return n;
+}
+
+void FFT::forward(std::complex<double>* data) const
+{
+    transform(data, false);
+}
+
+void FFT::inverse(std::complex<double>* data) const
+{
+    transform(data, true);
+    double scale = 1.0 / n;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        data[i] *= scale;
+    }
+}
+
+void FFT::transform(std::complex<double>* data, bool inverse) const
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (i < reversed[i])
+        {
+            std::swap(data[i], data[reversed[i]]);
+        }
+    }
+
+    for (std::size_t length = 2; length <= n; length <<= 1) // Butterfly span doubles every pass
+    {
+        std::size_t half = length / 2;
+        std::size_t stride = n / length; // Step through the twiddle table
+        for (std::size_t start = 0; start < n; start += length)
+        {
+            for (std::size_t k = 0; k < half; ++k)
+            {
+                std::complex<double> w = inverse ? std::conj(twiddles[k * stride]) : twiddles[k * stride];
+                std::complex<double> u = data[start + k];
+                std::complex<double> v = data[start + k + half] * w;
+                data[start + k] = u + v;
+                data[start + k + half] = u - v;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+/*
+ * File: FFT.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the FFT class, an iterative radix-2 Fast Fourier Transform of a fixed power-of-two size.
+ * Twiddle factors and the bit-reversal permutation are computed once in the constructor, so an FFT object can be
+ * reused for many transforms of the same size. The transforms are const and may be shared between threads.
+ * It is used for the O(N log N) Volterra convolution of the rough Bergomi model.
+ */
+
+#ifndef FFT_HPP
+#define FFT_HPP
+
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+class FFT
+{
+private:
+    std::size_t n; // Transform size (a power of two)
+    std::vector<std::complex<double>> twiddles; // exp(-2 pi i k / n) for k < n / 2
+    std::vector<std::size_t> reversed; // Bit-reversal permutation
+
+    void transform(std::complex<double>* data, bool inverse) const; // In-place butterfly passes
+
+public:
+    explicit FFT(std::size_t size); // Constructor, size must be a power of two
+    static std::size_t nextPowerOfTwo(std::size_t m); // Smallest power of two not below m
+
+    std::size_t size() const; // Transform size
+    void forward(std::complex<double>* data) const; // In-place forward transform
+    void inverse(std::complex<double>* data) const; // In-place inverse transform (scaled by 1 / n)
+};
+
+#endif // FFT_HPP
\ No newline at end of file
@@ -0,0 +1,122 @@
+/*
+ * File: Generator.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the Generator class template, a minimal C++20 coroutine generator. A function returning
+ * Generator<T> may co_yield values of type T; the caller pulls them one at a time with a range-based for loop.
+ * The producer is suspended between values, so nothing is computed until the consumer asks for it.
+ * Yielded values are passed by reference and are only valid until the consumer advances the iterator.
+ * Exceptions thrown inside the coroutine are rethrown to the consumer.
+ */
+
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+template <typename T>
+class Generator
+{
+public:
+    struct promise_type
+    {
+        const T* current = nullptr; // Address of the most recently yielded value
+        std::exception_ptr exception; // Exception thrown by the coroutine body, if any
+
+        Generator get_return_object()
+        {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; } // Do no work until the first value is requested
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const T& value) noexcept
+        {
+            current = std::addressof(value); // The value lives in the suspended coroutine frame
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    class iterator
+    {
+    private:
+        std::coroutine_handle<promise_type> handle; // Coroutine being iterated (null for the end iterator)
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using reference = const T&;
+        using pointer = const T*;
+
+        iterator() = default;
+        explicit iterator(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+        iterator& operator++()
+        {
+            resume(handle);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        reference operator*() const { return *handle.promise().current; }
+        pointer operator->() const { return handle.promise().current; }
+        bool operator==(std::default_sentinel_t) const { return !handle || handle.done(); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle; // Owned coroutine frame
+
+    explicit Generator(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+    static void resume(std::coroutine_handle<promise_type> h)
+    {
+        h.resume(); // Run the producer until its next co_yield or completion
+        if (h.promise().exception)
+        {
+            std::rethrow_exception(std::exchange(h.promise().exception, nullptr)); // Propagate producer errors
+        }
+    }
+
+public:
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+    Generator(Generator&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Generator& operator=(Generator&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+            {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~Generator()
+    {
+        if (handle)
+        {
+            handle.destroy(); // Destroying a suspended frame releases everything the producer holds
+        }
+    }
+
+    iterator begin()
+    {
+        if (handle)
+        {
+            resume(handle); // Produce the first value
+        }
+        return iterator(handle);
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+};
+
+#endif // GENERATOR_HPP
\ No newline at end of file
@@ -0,0 +1,129 @@
+/*
+ * File: Greeks.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines forwardGreeks(), a pathwise forward-mode sensitivity engine. The SDE Kernel, the FDM step and
+ * the payoff value() are instantiated with Dual<K>, where each lane is seeded on one input: the initial price S0
+ * (lane input -1) or a model parameter (lane input i selects parameters()[i], e.g. mu and sigma of GBM for rho and
+ * vega). A single simulation then returns the price and all K sensitivities, with no tape and no bumped re-runs.
+ * Like MCSolver, paths run in fixed-size chunks on the shared ThreadPool with one RNG stream per chunk, and
+ * payoffs are not discounted. Pathwise derivatives need payoffs that are continuous in the path, so barrier and
+ * digital payoffs are not supported here.
+ */
+
+#ifndef GREEKS_HPP
+#define GREEKS_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+#include "Dual.hpp"
+#include "MCSolver.hpp"
+#include "RNG.hpp"
+#include "ThreadPool.hpp"
+
+template <std::size_t K>
+struct ForwardGreeks
+{
+    double price; // Average payoff
+    std::array<double, K> sensitivities; // Derivative of the price along each seeded lane
+};
+
+template <typename Scheme, std::size_t K, typename Model, typename Claim>
+ForwardGreeks<K> forwardGreeks(const Model& model, const Claim& claim, std::shared_ptr<RNG> rng, double S0, double T, int N, int M,
+    const std::array<int, K>& inputs)
+{
+    using Real = Dual<K>;
+    if (!rng)
+    {
+        throw std::invalid_argument("RNG pointer is null in forwardGreeks.");
+    }
+    if (S0 <= 0 || T <= 0 || N <= 0 || M <= 0)
+    {
+        throw std::invalid_argument("Initial conditions (S0, T, N, M) must be positive.");
+    }
+
+    auto values = model.parameters();
+    std::array<Real, std::tuple_size<decltype(values)>::value> parameters;
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        parameters[i] = Real(values[i]);
+    }
+    Real start(S0);
+    for (std::size_t k = 0; k < K; ++k)
+    {
+        if (inputs[k] < 0)
+        {
+            start.tangent[k] = 1.0; // Delta lane
+        }
+        else if (static_cast<std::size_t>(inputs[k]) < parameters.size())
+        {
+            parameters[inputs[k]].tangent[k] = 1.0; // Parameter lane
+        }
+        else
+        {
+            throw std::invalid_argument("Sensitivity input does not name a model parameter.");
+        }
+    }
+    auto kernel = Model::template Kernel<Real>::from(parameters);
+
+    double dt = T / N;
+    double sqrtDt = std::sqrt(dt);
+    int chunks = (M + MCSolver::chunkPaths - 1) / MCSolver::chunkPaths;
+    std::vector<Real> partial(chunks);
+
+    auto simulate = [&](std::size_t c, RNG& generator)
+    {
+        int count = std::min(MCSolver::chunkPaths, M - static_cast<int>(c) * MCSolver::chunkPaths);
+        std::vector<double> z(N);
+        std::vector<Real> path(N + 1);
+        Real sum(0.0);
+        for (int p = 0; p < count; ++p)
+        {
+            generator.generateBlock(z.data(), N);
+            path[0] = start;
+            for (int j = 0; j < N; ++j)
+            {
+                path[j + 1] = Scheme::step(kernel, path[j], j * dt, dt, sqrtDt * z[j]); // Value and K tangents in one update
+            }
+            sum += claim.value(path);
+        }
+        partial[c] = sum;
+    };
+
+    if (!rng->stream(0))
+    {
+        for (int c = 0; c < chunks; ++c)
+        {
+            simulate(c, *rng); // The RNG cannot be split: simulate every chunk on this thread
+        }
+    }
+    else
+    {
+        ThreadPool::instance().parallelFor(chunks, [&](std::size_t c)
+        {
+            simulate(c, *rng->stream(c)); // Each chunk draws from its own stream
+        });
+    }
+
+    Real total(0.0);
+    for (int c = 0; c < chunks; ++c)
+    {
+        total += partial[c]; // Combine in chunk order so the result does not depend on scheduling
+    }
+    ForwardGreeks<K> result;
+    result.price = total.value / M;
+    for (std::size_t k = 0; k < K; ++k)
+    {
+        result.sensitivities[k] = total.tangent[k] / M;
+    }
+    return result;
+}
+
+#endif // GREEKS_HPP
\ No newline at end of file
@@ -0,0 +1,304 @@
+/*
+ * File: Hedging.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the hedge ratios and the HedgeSimulator class. Along a path the hedger holds delta_j shares
+ * from t_j to t_(j+1) and the rest of its wealth in cash, so with a cost rate c the P&L at maturity of a short option is
+ *     cash_N + delta_(N-1) S_N - payoff,  cash_0 = premium - delta_0 S_0 - c |delta_0| S_0,
+ *     cash_j = cash_(j-1) e^(r dt) - (delta_j - delta_(j-1)) S_j - c |delta_j - delta_(j-1)| S_j.
+ * Every row of a path block is rebalanced at once, so the hedge ratios of a whole block come from one deltaBlock() call.
+ */
+
+#include "Hedging.hpp"
+#include "MCSolver.hpp"
+#include "PathBlock.hpp"
+#include "PathGenerator.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+
+static double normalCdf(double x)
+{
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+void HedgeRatio::deltaBlock(const double* S, double* out, std::size_t n, double t) const
+{
+    for (std::size_t p = 0; p < n; ++p)
+    {
+        out[p] = delta(S[p], t);
+    }
+}
+
+BlackScholesHedge::BlackScholesHedge(double K, double r, double sigma, double T, bool isCall) : K(K), r(r), sigma(sigma), T(T), isCall(isCall)
+{
+    if (K <= 0 || sigma <= 0 || T <= 0)
+    {
+        throw std::invalid_argument("Strike, volatility and maturity must be positive.");
+    }
+}
+
+double BlackScholesHedge::value(double S, double t) const
+{
+    double tau = std::max(T - t, 1e-12); // Time to maturity
+    double d1 = (std::log(S / K) + (r + 0.5 * sigma * sigma) * tau) / (sigma * std::sqrt(tau));
+    double d2 = d1 - sigma * std::sqrt(tau);
+    double discount = std::exp(-r * tau);
+    return isCall ? S * normalCdf(d1) - K * discount * normalCdf(d2) : K * discount * normalCdf(-d2) - S * normalCdf(-d1);
+}
+
+double BlackScholesHedge::delta(double S, double t) const
+{
+    double tau = std::max(T - t, 1e-12);
+    double d1 = (std::log(S / K) + (r + 0.5 * sigma * sigma) * tau) / (sigma * std::sqrt(tau));
+    return isCall ? normalCdf(d1) : normalCdf(d1) - 1.0;
+}
+
+RegressionHedge::RegressionHedge(std::shared_ptr<SDE> sde, std::shared_ptr<FDM> fdm, std::shared_ptr<RNG> rng, std::shared_ptr<Payoff> payoff,
+    double S0, double r, double T, int N, int paths, int bins, double span, double dispersion)
+    : S0(S0), dt(T / N), bins(bins), span(span)
+{
+    if (!sde || !fdm || !rng || !payoff)
+    {
+        throw std::invalid_argument("One or more components (SDE, FDM, RNG, Payoff) are null.");
+    }
+    if (S0 <= 0 || T <= 0 || N <= 0 || paths <= 0 || bins < 2 || span <= 0 || dispersion <= 0)
+    {
+        throw std::invalid_argument("S0, T, N, training paths, bins, span and dispersion must be positive.");
+    }
+    std::vector<double> observed = payoff->observationTimes(T);
+    if (sde->simulatesPaths() || observed.size() != 1 || std::abs(observed[0] - T) > 1e-12 * T)
+    {
+        throw std::invalid_argument("Regression hedges need a Markov model stepped by an FDM scheme and a payoff paid on the price at maturity.");
+    }
+
+    std::size_t size = 3 * static_cast<std::size_t>(bins); // Count, value sum and delta sum of every bin of one date
+    int chunks = (paths + MCSolver::chunkPaths - 1) / MCSolver::chunkPaths;
+    std::vector<double> partial(chunks * N * size, 0.0); // Bin sums of every date, per chunk
+    std::vector<double> times(N + 1);
+    for (int j = 0; j <= N; ++j)
+    {
+        times[j] = j * dt;
+    }
+    double sqrtDt = std::sqrt(dt);
+    double width = 2 * span / bins;
+
+    auto train = [&](RNG& generator, int c)
+    {
+        int count = std::min(MCSolver::chunkPaths, paths - c * MCSolver::chunkPaths);
+        std::size_t capacity = PathGenerator::defaultBlockSize;
+        PathBlock block(capacity, times);
+        std::vector<double> Y((N + 1) * capacity); // Y[j * capacity + p]: dS_j / dS_0 along path p
+        std::vector<double> dW(capacity), bumped(capacity), shifted(capacity);
+        double* sums = &partial[static_cast<std::size_t>(c) * N * size];
+        for (int first = 0; first < count; first += static_cast<int>(capacity))
+        {
+            std::size_t n = std::min<std::size_t>(capacity, count - first);
+            block.resize(n);
+            double* start = block.row(0);
+            generator.generateBlock(start, n);
+            for (std::size_t p = 0; p < n; ++p)
+            {
+                start[p] = S0 * std::exp(dispersion * start[p] - 0.5 * dispersion * dispersion); // Spread the start around S0
+                Y[p] = 1.0;
+            }
+            for (int j = 0; j < N; ++j)
+            {
+                generator.generateBlock(dW.data(), n);
+                const double* S = block.row(j);
+                for (std::size_t p = 0; p < n; ++p)
+                {
+                    dW[p] *= sqrtDt;
+                    shifted[p] = S[p] * (1 + bump);
+                }
+                fdm->advanceBlock(S, block.row(j + 1), n, j * dt, dt, dW.data());
+                fdm->advanceBlock(shifted.data(), bumped.data(), n, j * dt, dt, dW.data()); // Same increments from a bumped start
+                sde->applyBoundary(S, block.row(j + 1), n); // Training keeps every path, so Reject only truncates here
+                sde->applyBoundary(shifted.data(), bumped.data(), n);
+                const double* next = block.row(j + 1);
+                for (std::size_t p = 0; p < n; ++p)
+                {
+                    Y[(j + 1) * capacity + p] = Y[j * capacity + p] * (bumped[p] - next[p]) / (S[p] * bump);
+                }
+            }
+
+            const double* ST = block.terminal();
+            for (std::size_t p = 0; p < n; ++p)
+            {
+                double h = bump * ST[p];
+                double slope = ((*payoff)(ST[p] + h) - (*payoff)(ST[p] - h)) / (2 * h); // Payoff derivative at maturity
+                double value = (*payoff)(ST[p]);
+                for (int j = 0; j < N; ++j)
+                {
+                    double u = std::log(block.row(j)[p] / S0);
+                    int k = std::clamp(static_cast<int>(std::floor((u + span) / width)), 0, bins - 1); // Edge bins collect the tails
+                    double discount = std::exp(-r * (T - j * dt));
+                    double* bin = sums + j * size + 3 * k;
+                    bin[0] += 1.0;
+                    bin[1] += discount * value; // Realised payoff in date j money
+                    bin[2] += discount * slope * Y[N * capacity + p] / Y[j * capacity + p]; // Pathwise delta from date j
+                }
+            }
+        }
+    };
+
+    if (!rng->stream(0))
+    {
+        for (int c = 0; c < chunks; ++c)
+        {
+            train(*rng, c); // The RNG cannot be split: simulate every chunk on this thread
+        }
+    }
+    else
+    {
+        ThreadPool::instance().parallelFor(chunks, [&](std::size_t c)
+        {
+            train(*rng->stream(trainingStream + c), static_cast<int>(c)); // Each chunk draws from its own stream
+        });
+    }
+
+    values.assign(N * bins, 0.0);
+    deltas.assign(N * bins, 0.0);
+    std::vector<double> counts(bins);
+    for (int j = 0; j < N; ++j)
+    {
+        std::fill(counts.begin(), counts.end(), 0.0);
+        for (int c = 0; c < chunks; ++c)
+        {
+            const double* bin = &partial[(static_cast<std::size_t>(c) * N + j) * size];
+            for (int k = 0; k < bins; ++k)
+            {
+                counts[k] += bin[3 * k]; // Combine in chunk order so the fit does not depend on scheduling
+                values[j * bins + k] += bin[3 * k + 1];
+                deltas[j * bins + k] += bin[3 * k + 2];
+            }
+        }
+        int last = -1; // Last non-empty bin
+        for (int k = 0; k < bins; ++k)
+        {
+            if (counts[k] > 0)
+            {
+                values[j * bins + k] /= counts[k];
+                deltas[j * bins + k] /= counts[k];
+                for (int e = last + 1; e < k; ++e) // Empty bins take the nearest bin to their right...
+                {
+                    values[j * bins + e] = values[j * bins + k];
+                    deltas[j * bins + e] = deltas[j * bins + k];
+                }
+                last = k;
+            }
+        }
+        for (int e = last + 1; last >= 0 && e < bins; ++e) // ...or, past the last one, the last non-empty bin
+        {
+            values[j * bins + e] = values[j * bins + last];
+            deltas[j * bins + e] = deltas[j * bins + last];
+        }
+    }
+}
+
+double RegressionHedge::evaluate(const std::vector<double>& table, double S, double t) const
+{
+    int dates = static_cast<int>(table.size()) / bins;
+    int j = std::clamp(static_cast<int>(std::lround(t / dt)), 0, dates - 1); // Date nearest to t
+    double position = (std::log(S / S0) + span) * bins / (2 * span) - 0.5; // In units of bins, 0 at the first bin centre
+    position = std::clamp(position, 0.0, bins - 1.0);
+    int k = std::min(static_cast<int>(position), bins - 2);
+    double w = position - k;
+    const double* row = &table[j * bins];
+    return (1 - w) * row[k] + w * row[k + 1]; // Linear interpolation between bin centres
+}
+
+double RegressionHedge::value(double S, double t) const
+{
+    return evaluate(values, S, t);
+}
+
+double RegressionHedge::delta(double S, double t) const
+{
+    return evaluate(deltas, S, t);
+}
+
+HedgeSimulator::HedgeSimulator(std::shared_ptr<SDE> sde, std::shared_ptr<FDM> fdm, std::shared_ptr<RNG> rng, std::shared_ptr<Payoff> payoff,
+    std::shared_ptr<HedgeRatio> hedge, double S0, double r, double T, int N, int M, double cost)
+    : sde(sde), fdm(fdm), rng(rng), payoff(payoff), hedge(hedge), S0(S0), r(r), T(T), N(N), M(M), cost(cost)
+{
+    if (!sde || !fdm || !rng || !payoff || !hedge)
+    {
+        throw std::invalid_argument("One or more components (SDE, FDM, RNG, Payoff, HedgeRatio) are null.");
+    }
+    if (S0 <= 0 || T <= 0 || N <= 0 || M <= 0 || cost < 0)
+    {
+        throw std::invalid_argument("Initial conditions (S0, T, N, M) must be positive and the cost rate non-negative.");
+    }
+}
+
+void HedgeSimulator::hedgePaths(std::shared_ptr<RNG> generator, int count, double premium, QuantileSketch& pnl) const
+{
+    double dt = T / N;
+    double growth = std::exp(r * dt); // Interest on the cash account over one step
+    double delta0 = hedge->delta(S0, 0.0);
+    PathGenerator producer = sde->simulatesPaths() ? PathGenerator(sde, generator, S0, T, N, count)
+        : PathGenerator(fdm, generator, S0, T, N, count);
+    std::size_t size = PathGenerator::defaultBlockSize;
+    std::vector<double> cash(size), position(size), target(size), values(size);
+
+    for (const PathBlock& block : producer.blocks())
+    {
+        std::size_t n = block.size();
+        std::fill(position.begin(), position.begin() + n, delta0);
+        std::fill(cash.begin(), cash.begin() + n, premium - delta0 * S0 - cost * std::abs(delta0) * S0);
+        for (int j = 1; j < N; ++j)
+        {
+            const double* S = block.row(j);
+            hedge->deltaBlock(S, target.data(), n, j * dt);
+            for (std::size_t p = 0; p < n; ++p)
+            {
+                double traded = target[p] - position[p];
+                cash[p] = cash[p] * growth - traded * S[p] - cost * std::abs(traded) * S[p];
+                position[p] = target[p];
+            }
+        }
+
+        const double* ST = block.terminal();
+        const std::uint8_t* rejected = block.rejected();
+        payoff->evaluateBlock(block, values.data());
+        for (std::size_t p = 0; p < n; ++p)
+        {
+            if (!rejected[p]) // Paths rejected by the boundary policy are not part of the P&L distribution
+            {
+                pnl.add(cash[p] * growth + position[p] * ST[p] - values[p]); // Hedge portfolio minus the option paid out
+            }
+        }
+    }
+}
+
+HedgeReport HedgeSimulator::solve()
+{
+    if (sde->simulatesPaths())
+    {
+        sde->calibrate(S0, T, N, rng); // Fit grid-dependent model state once, before the chunks share it
+    }
+    double premium = hedge->value(S0, 0.0);
+    HedgeReport report{ premium, QuantileSketch() };
+
+    if (!rng->stream(0))
+    {
+        hedgePaths(rng, M, premium, report.pnl); // The RNG cannot be split: simulate every path on this thread
+        return report;
+    }
+
+    int chunks = (M + MCSolver::chunkPaths - 1) / MCSolver::chunkPaths;
+    std::vector<QuantileSketch> partial(chunks); // One sketch per chunk
+    ThreadPool::instance().parallelFor(chunks, [&](std::size_t c)
+    {
+        int count = std::min(MCSolver::chunkPaths, M - static_cast<int>(c) * MCSolver::chunkPaths);
+        hedgePaths(rng->stream(c), count, premium, partial[c]); // Each chunk draws from its own stream
+    });
+    for (const QuantileSketch& sketch : partial)
+    {
+        report.pnl.merge(sketch); // Merge in chunk order so the result does not depend on scheduling
+    }
+    return report;
+}
\ No newline at end of file
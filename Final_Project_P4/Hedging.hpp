@@ -0,0 +1,112 @@
+/*
+ * File: Hedging.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the delta-hedging backtest. HedgeSimulator sells an option at the hedger's model value, then
+ * along every simulated path rebalances a stock position to the hedge ratio at each time step, financing it through
+ * a cash account that earns the rate r and paying an optional proportional transaction cost. The hedging P&L at
+ * maturity is recorded in a QuantileSketch, so its mean, spread, quantiles and tail are available without storing
+ * the paths; path blocks run in parallel chunks with one sketch each, merged in chunk order.
+ * The hedge ratio is a HedgeRatio evaluated per path and per rebalance date, never by nested simulation:
+ * BlackScholesHedge uses the closed-form delta, and RegressionHedge is a fast proxy for any Markov model stepped by an
+ * FDM scheme. On a set of training paths it regresses, at every date, the discounted payoff (for the value) and its
+ * pathwise derivative f'(S_T) dS_T/dS_t (for the delta) on the price, as piecewise-linear functions through the
+ * averages of bins in log-price; the conditional expectation of the pathwise derivative is the delta, and it is far
+ * better behaved than the slope of a fitted value, even close to maturity where the delta is steep. The training
+ * paths start from a lognormal spread around S0 (the conditional value at a date only depends on the price then),
+ * so even the first dates see a wide range of prices.
+ */
+
+#ifndef HEDGING_HPP
+#define HEDGING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "SDE.hpp"
+#include "FDM.hpp"
+#include "RNG.hpp"
+#include "Payoff.hpp"
+#include "Sketch.hpp"
+
+class HedgeRatio
+{
+public:
+    virtual ~HedgeRatio() = default;
+    virtual double value(double S, double t) const = 0; // Hedger's value of the option at time t
+    virtual double delta(double S, double t) const = 0; // Stock position held at time t
+    virtual void deltaBlock(const double* S, double* out, std::size_t n, double t) const; // Hedge ratios of n paths at time t
+};
+
+class BlackScholesHedge : public HedgeRatio
+{
+private:
+    double K; // Strike price
+    double r; // Risk-free rate
+    double sigma; // Volatility assumed by the hedger
+    double T; // Maturity
+    bool isCall; // True for call option, false for put option
+
+public:
+    BlackScholesHedge(double K, double r, double sigma, double T, bool isCall); // Constructor
+    double value(double S, double t) const override; // Black-Scholes price
+    double delta(double S, double t) const override; // Black-Scholes delta
+};
+
+class RegressionHedge : public HedgeRatio
+{
+private:
+    double S0; // Initial stock price (bins are laid out in log(S / S0))
+    double dt; // Time step of the training grid
+    int bins; // Number of price bins per date
+    double span; // Bins cover log(S / S0) in [-span, span]
+    std::vector<double> values; // Mean discounted payoff of every bin, date by date
+    std::vector<double> deltas; // Mean pathwise delta of every bin, date by date
+
+    double evaluate(const std::vector<double>& table, double S, double t) const; // Interpolate the table of the date nearest to t
+
+public:
+    static constexpr std::uint64_t trainingStream = std::uint64_t(1) << 40; // First RNG stream of the training paths
+    static constexpr double bump = 1e-4; // Relative bump of the finite-difference derivatives
+
+    RegressionHedge(std::shared_ptr<SDE> sde, std::shared_ptr<FDM> fdm, std::shared_ptr<RNG> rng, std::shared_ptr<Payoff> payoff,
+        double S0, double r, double T, int N, int paths, int bins = 100, double span = 1.0,
+        double dispersion = 0.25); // Fit value and delta at every date on training paths
+    double value(double S, double t) const override; // Regressed value
+    double delta(double S, double t) const override; // Regressed pathwise delta
+};
+
+struct HedgeReport
+{
+    double premium; // Hedger's value of the option at time 0, received when selling it
+    QuantileSketch pnl; // Distribution of the hedging P&L at maturity
+};
+
+class HedgeSimulator
+{
+private:
+    std::shared_ptr<SDE> sde; // Model of the simulated market
+    std::shared_ptr<FDM> fdm; // Scheme used to step the paths
+    std::shared_ptr<RNG> rng; // Random Number Generator
+    std::shared_ptr<Payoff> payoff; // Option sold
+    std::shared_ptr<HedgeRatio> hedge; // Hedge ratio and value of the hedger
+    double S0; // Initial stock price
+    double r; // Rate earned by the cash account
+    double T;  // Maturity (time to expiration)
+    int N;     // Number of time steps (one rebalance per step)
+    int M;     // Number of simulated paths
+    double cost; // Proportional transaction cost on traded stock value
+
+    void hedgePaths(std::shared_ptr<RNG> generator, int count, double premium, QuantileSketch& pnl) const; // Hedge count paths into pnl
+
+public:
+    HedgeSimulator(std::shared_ptr<SDE> sde, std::shared_ptr<FDM> fdm, std::shared_ptr<RNG> rng, std::shared_ptr<Payoff> payoff,
+        std::shared_ptr<HedgeRatio> hedge, double S0, double r, double T, int N, int M, double cost = 0.0); // Constructor
+    HedgeReport solve(); // Backtest the hedge on M paths
+};
+
+#endif // HEDGING_HPP
\ No newline at end of file
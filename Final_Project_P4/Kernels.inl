@@ -0,0 +1,244 @@
+/*
+ * File: Kernels.inl
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file holds the bodies of the batch kernels. It is included once by each KernelsXXX.cpp translation unit,
+ * after that unit has included KernelsPrologue.hpp and every other header, switched the compiler to its instruction set and defined KERNEL_VECTOR
+ * as the matching simd type; it produces one KernelTable named table in namespace KERNEL_NAMESPACE.
+ * Every kernel walks a row of paths one vector at a time, and the last, partial vector is handled with masked loads
+ * and stores rather than a scalar remainder loop. Conditions (boundary policies, barrier hits, the choice of root of
+ * the inverse Gaussian) are comparisons and selects under masks.
+ * The step kernels instantiate the FDM scheme templates with the model Kernel templates over the vector type, so a
+ * model written once as a Kernel template is stepped at the full vector width by every scheme; SIMD_FLATTEN inlines
+ * the whole call tree into the kernel, where the instruction set of this unit applies.
+ * The file deliberately includes nothing: inline functions pulled in from headers here would be compiled for the
+ * wider instruction set and could be picked by the linker for the whole program.
+ */
+
+namespace KERNEL_NAMESPACE
+{
+    using Vec = KERNEL_VECTOR;
+
+    static std::size_t lanes(std::size_t n, std::size_t p) // Active lanes of the vector starting at path p
+    {
+        return n - p < Vec::width ? n - p : Vec::width;
+    }
+
+    static std::size_t count(unsigned bits) // Number of set lanes
+    {
+        std::size_t c = 0;
+        for (; bits; bits &= bits - 1)
+        {
+            ++c;
+        }
+        return c;
+    }
+
+    template <typename Scheme, typename Model, std::size_t K>
+    SIMD_FLATTEN static void step(const double* parameters, const double* S, double* out, std::size_t n, double t, double dt, const double* dW)
+    {
+        std::array<Vec, K> broadcast;
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            broadcast[k] = Vec(parameters[k]);
+        }
+        auto model = Model::template Kernel<Vec>::from(broadcast);
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            Scheme::step(model, Vec::load(S + p, m), t, dt, Vec::load(dW + p, m)).store(out + p, m);
+        }
+    }
+
+    SIMD_FLATTEN static std::size_t absorb(const double* previous, double* next, std::size_t n)
+    {
+        std::size_t fired = 0;
+        Vec zero(0.0);
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            Vec x = Vec::load(next + p, m);
+            fired += count(bits(x < zero));
+            select((Vec::load(previous + p, m) > zero) & (x > zero), x, zero).store(next + p, m); // Zero stays zero
+        }
+        return fired;
+    }
+
+    SIMD_FLATTEN static std::size_t reflect(double* next, std::size_t n)
+    {
+        std::size_t fired = 0;
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            Vec x = Vec::load(next + p, m);
+            fired += count(bits(x < Vec(0.0)));
+            abs(x).store(next + p, m);
+        }
+        return fired;
+    }
+
+    SIMD_FLATTEN static std::size_t truncate(double* next, std::size_t n)
+    {
+        std::size_t fired = 0;
+        Vec zero(0.0);
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            Vec x = Vec::load(next + p, m);
+            fired += count(bits(x < zero));
+            select(x > zero, x, zero).store(next + p, m);
+        }
+        return fired;
+    }
+
+    SIMD_FLATTEN static std::size_t reject(double* next, std::uint8_t* rejected, std::size_t n)
+    {
+        std::size_t fired = 0;
+        Vec zero(0.0);
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            Vec x = Vec::load(next + p, m);
+            unsigned below = bits(x < zero);
+            fired += count(below);
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                rejected[p + i] |= (below >> i) & 1u;
+            }
+            select(x > zero, x, zero).store(next + p, m); // Keep the rejected path finite for consumers that ignore the flags
+        }
+        return fired;
+    }
+
+    SIMD_FLATTEN static void scale(double* x, std::size_t n, double factor)
+    {
+        Vec f(factor);
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            (Vec::load(x + p, m) * f).store(x + p, m);
+        }
+    }
+
+    SIMD_FLATTEN static void affine(double* x, std::size_t n, double factor, double shift)
+    {
+        Vec f(factor), s(shift);
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            (Vec::load(x + p, m) * f + s).store(x + p, m);
+        }
+    }
+
+    SIMD_FLATTEN static void inverseGaussian(const double* normals, const double* uniforms, double* out, std::size_t n, double mean, double shape)
+    {
+        Vec mu(mean), lambda4(4.0 * shape), ratio(mean / (2.0 * shape));
+        for (std::size_t i = 0; i < n; i += Vec::width)
+        {
+            std::size_t m = lanes(n, i);
+            Vec z = Vec::load(normals + i, m);
+            Vec y = mu * z * z;
+            Vec larger = mu + ratio * (y + sqrt(lambda4 * y + y * y)); // Larger root of the chi-square transform
+            Vec smaller = mu * mu / larger; // The roots multiply to mean^2; avoids cancellation
+            select(Vec::load(uniforms + i, m) * (mu + smaller) <= mu, smaller, larger).store(out + i, m); // Pick a root with probability mean / (mean + root)
+        }
+    }
+
+    SIMD_FLATTEN static void callPayoff(const double* S, double* out, std::size_t n, double K)
+    {
+        Vec strike(K), zero(0.0);
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            max(Vec::load(S + p, m) - strike, zero).store(out + p, m);
+        }
+    }
+
+    SIMD_FLATTEN static void putPayoff(const double* S, double* out, std::size_t n, double K)
+    {
+        Vec strike(K), zero(0.0);
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            max(strike - Vec::load(S + p, m), zero).store(out + p, m);
+        }
+    }
+
+    SIMD_FLATTEN static void runningMax(double* extreme, const double* row, std::size_t n)
+    {
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            max(Vec::load(extreme + p, m), Vec::load(row + p, m)).store(extreme + p, m);
+        }
+    }
+
+    SIMD_FLATTEN static void runningMin(double* extreme, const double* row, std::size_t n)
+    {
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            min(Vec::load(extreme + p, m), Vec::load(row + p, m)).store(extreme + p, m);
+        }
+    }
+
+    SIMD_FLATTEN static void barrierSettle(const double* ST, double* extreme, std::size_t n, double K, double B, bool isCall, bool isUp, bool isIn)
+    {
+        Vec strike(K), barrier(B), zero(0.0);
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            Vec S = Vec::load(ST + p, m), e = Vec::load(extreme + p, m);
+            Vec intrinsic = max(isCall ? S - strike : strike - S, zero);
+            auto hit = isUp ? e >= barrier : e <= barrier; // Was the barrier touched?
+            (isIn ? select(hit, intrinsic, zero) : select(hit, zero, intrinsic)).store(extreme + p, m); // In pays if hit, out if not
+        }
+    }
+
+    // Node k of the new row reads nodes k to k + 2 of the old one, which are loaded before the store: the row can be
+    // overwritten in place from the bottom up, one vector at a time
+    SIMD_FLATTEN static void binomialStep(double* V, std::size_t n, double down, double up)
+    {
+        Vec d(down), u(up);
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            (d * Vec::load(V + p, m) + u * Vec::load(V + p + 1, m)).store(V + p, m);
+        }
+    }
+
+    SIMD_FLATTEN static void trinomialStep(double* V, std::size_t n, double down, double middle, double up)
+    {
+        Vec d(down), c(middle), u(up);
+        for (std::size_t p = 0; p < n; p += Vec::width)
+        {
+            std::size_t m = lanes(n, p);
+            (d * Vec::load(V + p, m) + c * Vec::load(V + p + 1, m) + u * Vec::load(V + p + 2, m)).store(V + p, m);
+        }
+    }
+
+    static const KernelTable table = {
+        .isa = KERNEL_ISA,
+        .name = KERNEL_NAME,
+        .euler = { step<EulerMethod, GBM, 2>, step<EulerMethod, CEV, 3>, step<EulerMethod, CIR, 3> },
+        .milstein = { step<MilsteinMethod, GBM, 2>, step<MilsteinMethod, CEV, 3>, step<MilsteinMethod, CIR, 3> },
+        .predictorCorrector = { step<DriftAdjustedPredictorCorrector, GBM, 2>, step<DriftAdjustedPredictorCorrector, CEV, 3>,
+            step<DriftAdjustedPredictorCorrector, CIR, 3> },
+        .absorb = absorb,
+        .reflect = reflect,
+        .truncate = truncate,
+        .reject = reject,
+        .scale = scale,
+        .affine = affine,
+        .inverseGaussian = inverseGaussian,
+        .callPayoff = callPayoff,
+        .putPayoff = putPayoff,
+        .runningMax = runningMax,
+        .runningMin = runningMin,
+        .barrierSettle = barrierSettle,
+        .binomialStep = binomialStep,
+        .trinomialStep = trinomialStep
+    };
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+/*
+ * File: KernelsAVX2.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file builds the AVX2 KernelTable (four-lane vectors with fused multiply-add). GCC and Clang are switched to AVX2 by a pragma placed
+ * after every #include, so only the kernels themselves use the wider instructions; MSVC compiles this file with
+ * /arch:AVX2 (set per file in the project). The table is only selected on hosts where detectIsa() reports AVX2.
+ */
+
+#include "KernelsPrologue.hpp" // First: fixes the floating-point contraction of the whole unit
+#include "Dispatch.hpp"
+#include "FDM.hpp"
+#include "Simd.hpp"
+#include <array>
+#include <cmath>
+
+#if defined(MC_X86)
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+#define KERNEL_NAMESPACE avx2
+#define KERNEL_VECTOR simd::AVX2
+#define KERNEL_ISA Isa::AVX2
+#define KERNEL_NAME "AVX2"
+#include "Kernels.inl"
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+const KernelTable* avx2Kernels()
+{
+    return &avx2::table;
+}
+#else
+const KernelTable* avx2Kernels()
+{
+    return nullptr; // No AVX2 on this target
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+/*
+ * File: KernelsAVX512.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file builds the AVX-512 KernelTable (eight-lane vectors). GCC and Clang are switched to AVX-512 by a pragma placed
+ * after every #include, so only the kernels themselves use the wider instructions; MSVC compiles this file with
+ * /arch:AVX512 (set per file in the project). The table is only selected on hosts where detectIsa() reports AVX-512.
+ */
+
+#include "KernelsPrologue.hpp" // First: fixes the floating-point contraction of the whole unit
+#include "Dispatch.hpp"
+#include "FDM.hpp"
+#include "Simd.hpp"
+#include <array>
+#include <cmath>
+
+#if defined(MC_X86)
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f,avx512dq,avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512dq,avx2,fma")
+#endif
+
+#define KERNEL_NAMESPACE avx512
+#define KERNEL_VECTOR simd::AVX512
+#define KERNEL_ISA Isa::AVX512
+#define KERNEL_NAME "AVX-512"
+#include "Kernels.inl"
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+const KernelTable* avx512Kernels()
+{
+    return &avx512::table;
+}
+#else
+const KernelTable* avx512Kernels()
+{
+    return nullptr; // No AVX-512 on this target
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,23 @@
+/*
+ * File: KernelsPrologue.hpp
+ * Author: Yumin Wu
+ * Date: 10/19/2026
+ *
+ * Description:
+ * This file is included first by each KernelsXXX.cpp translation unit, before any other header. It turns off the
+ * contraction of a multiply and an add into an FMA for the rest of the unit, unless the code asks for one, so every
+ * kernel table rounds the same operations and produces bit-identical results.
+ */
+
+#ifndef KERNELSPROLOGUE_HPP
+#define KERNELSPROLOGUE_HPP
+
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+#endif // KERNELSPROLOGUE_HPP
\ No newline at end of file
@@ -0,0 +1,34 @@
+/*
+ * File: KernelsSSE2.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file builds the baseline KernelTable with the project's default compiler settings: the two-lane SSE2 vectors
+ * on x86, which every x86-64 processor supports, and one-lane portable vectors elsewhere. It is the fallback of the
+ * runtime dispatch.
+ */
+
+#include "KernelsPrologue.hpp" // First: fixes the floating-point contraction of the whole unit
+#include "Dispatch.hpp"
+#include "FDM.hpp"
+#include "Simd.hpp"
+#include <array>
+#include <cmath>
+
+#define KERNEL_NAMESPACE baseline
+#if defined(MC_X86)
+#define KERNEL_VECTOR simd::SSE2
+#define KERNEL_ISA Isa::SSE2
+#define KERNEL_NAME "SSE2"
+#else
+#define KERNEL_VECTOR simd::Portable
+#define KERNEL_ISA Isa::Portable
+#define KERNEL_NAME "Portable"
+#endif
+#include "Kernels.inl"
+
+const KernelTable* baselineKernels()
+{
+    return &baseline::table;
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+/*
+ * File: LMM.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines a multi-factor LIBOR market model engine. The LiborMarketModel class holds a tenor structure of
+ * forward rates with lognormal volatilities and an exponential correlation structure reduced to a few factors by
+ * principal components. The LMMSolver class simulates the forward rates under the spot LIBOR measure, tracks the
+ * discretely compounded spot numeraire, and averages the deflated cash flows of LMMPayoff objects (Cap, Swaption).
+ * Forward rates are stored structure-of-arrays (rate-major, paths contiguous), so every update is a contiguous loop
+ * over the paths of a block. The drift uses the predictor-corrector idea of DriftAdjustedPredictorCorrector.
+ */
+
+#ifndef LMM_HPP
+#define LMM_HPP
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "RNG.hpp"
+#include "ThreadPool.hpp"
+
+class LiborMarketModel
+{
+private:
+    double tau; // Accrual period of every forward rate
+    std::vector<double> initial; // Initial forward rates L_j(0) over [T_j, T_j+1], T_j = j * tau
+    std::vector<double> vols; // Lognormal volatility of each forward rate
+    std::size_t factors; // Number of driving Brownian motions
+    std::vector<double> loadings; // loadings[j * factors + f]: exposure of rate j to factor f (rows have unit length)
+
+public:
+    LiborMarketModel(double tau, const std::vector<double>& forwards, const std::vector<double>& vols, double beta, std::size_t factors); // Constructor, correlation exp(-beta |T_i - T_j|)
+
+    std::size_t numRates() const; // Number of forward rates
+    std::size_t numFactors() const; // Number of factors
+    double accrual() const; // Accrual period tau
+    double forward(std::size_t j) const; // Initial forward rate L_j(0)
+    double vol(std::size_t j) const; // Volatility of rate j
+    double loading(std::size_t j, std::size_t f) const; // Exposure of rate j to factor f
+    double discount(std::size_t j) const; // Initial discount factor P(0, T_j)
+};
+
+class LiborBlock
+{
+private:
+    std::size_t capacity; // Maximum number of paths
+    std::size_t paths; // Number of active paths
+    std::size_t rates; // Number of forward rates
+    std::vector<double> forwards; // forwards[j * capacity + p]: rate j on path p
+    std::vector<double> numeraire; // Spot numeraire B(T_i) on each path at the current reset date
+
+public:
+    LiborBlock(std::size_t capacity, std::size_t rates); // Constructor
+
+    void resize(std::size_t n); // Set the number of active paths
+    std::size_t size() const; // Number of active paths
+    std::size_t numRates() const; // Number of forward rates
+    double* rate(std::size_t j); // Rate j on every path
+    const double* rate(std::size_t j) const; // Rate j on every path
+    double* spotNumeraire(); // Numeraire on every path
+    const double* spotNumeraire() const; // Numeraire on every path
+};
+
+class LMMPayoff
+{
+public:
+    virtual ~LMMPayoff() = default;
+    // Called at every reset date T_i with the rates observed at T_i; add each path's cash flows, deflated by the
+    // spot numeraire, to value[p]
+    virtual void atReset(std::size_t i, const LiborBlock& block, double tau, double* value) const = 0;
+};
+
+class Cap : public LMMPayoff
+{
+private:
+    double K; // Cap rate
+    std::size_t first; // First caplet (rate index)
+    std::size_t last; // One past the last caplet
+
+public:
+    Cap(double K, std::size_t first, std::size_t last); // Constructor, caplets on rates [first, last)
+    void atReset(std::size_t i, const LiborBlock& block, double tau, double* value) const override; // Caplet i pays tau * max(L_i - K, 0) at T_i+1
+};
+
+class Swaption : public LMMPayoff
+{
+private:
+    double K; // Fixed rate of the underlying swap
+    std::size_t expiry; // Exercise date index (the swap starts at T_expiry)
+    std::size_t end; // Swap ends at T_end
+    bool isPayer; // True for a payer swaption, false for a receiver swaption
+
+public:
+    Swaption(double K, std::size_t expiry, std::size_t end, bool isPayer); // Constructor
+    void atReset(std::size_t i, const LiborBlock& block, double tau, double* value) const override; // Exercise value at T_expiry
+};
+
+class LMMSolver
+{
+private:
+    std::shared_ptr<LiborMarketModel> model; // Forward rate model
+    std::shared_ptr<RNG> rng; // Random Number Generator for the factor shocks
+    int steps; // Time steps per accrual period
+    int M; // Number of Monte Carlo simulations
+
+    void simulate(RNG& generator, int count, const std::vector<std::shared_ptr<LMMPayoff>>& payoffs, double* sums) const; // Simulate count paths and add deflated payoffs to sums
+
+public:
+    static constexpr std::size_t blockSize = 256; // Paths simulated together
+
+    LMMSolver(std::shared_ptr<LiborMarketModel> model, std::shared_ptr<RNG> rng, int steps, int M); // Constructor
+    std::vector<double> solve(const std::vector<std::shared_ptr<LMMPayoff>>& payoffs); // Prices today of every payoff
+};
+
+#endif // LMM_HPP
\ No newline at end of file
@@ -0,0 +1,190 @@
+/*
+ * File: Lattice.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the LatticePricer class. Both trees keep the node values of one row in a vector that shrinks
+ * by one (binomial) or two (trinomial) nodes per step. The node prices are kept alongside: the binomial prices of a
+ * row are those of the next row times the up factor, and the trinomial prices of every row are a window of the
+ * maturity row, since the log-price nodes do not move. The trinomial probabilities match the mean and variance of
+ * the log-price step; with a barrier, the spacing is widened from sigma sqrt(3 dt) until a whole number of spacings
+ * separates log(S0) from log(B), and the number of steps is raised if even one spacing would be too wide.
+ */
+
+#include "Lattice.hpp"
+#include "Dispatch.hpp"
+#include <algorithm>
+#include <cmath>
+
+LatticePricer::LatticePricer(std::shared_ptr<SDE> sde, double S0, double T, Tree tree)
+    : r(0.0), sigma(0.0), S0(S0), T(T), tree(tree)
+{
+    BatchModel model;
+    double parameters[maxBatchParameters];
+    if (!sde || !sde->batchModel(model, parameters) || model != BatchModel::GBM)
+    {
+        throw std::invalid_argument("The lattice pricer needs a GBM model.");
+    }
+    r = parameters[0];
+    sigma = parameters[1];
+    if (S0 <= 0 || T <= 0 || sigma <= 0)
+    {
+        throw std::invalid_argument("The lattice pricer needs positive S0, T and volatility.");
+    }
+}
+
+double LatticePricer::price(const Payoff& payoff, bool american, int steps) const
+{
+    if (steps < 1)
+    {
+        throw std::invalid_argument("The lattice needs at least one step.");
+    }
+
+    double K, B;
+    bool isCall, isUp, isIn;
+    if (!payoff.barrier(K, B, isCall, isUp, isIn))
+    {
+        return tree == Tree::Binomial ? binomial(payoff, american, steps) : trinomial(payoff, american, steps, 0.0, false, false);
+    }
+    if (isIn && american)
+    {
+        throw std::invalid_argument("American knock-in options cannot be priced by in-out parity.");
+    }
+
+    EuropeanCall call(K);
+    EuropeanPut put(K);
+    const Payoff& vanilla = isCall ? static_cast<const Payoff&>(call) : put; // Payoff of the option while it is alive
+    if (isUp ? S0 >= B : S0 <= B) // Touched at inception: knocked in or out already
+    {
+        return isIn ? trinomial(vanilla, american, steps, 0.0, false, false) : 0.0;
+    }
+    steps = std::max(steps, minimumSteps(B));
+    double out = trinomial(vanilla, american, steps, B, isUp, true);
+    return isIn ? trinomial(vanilla, false, steps, B, isUp, false) - out : out; // Same nodes for both legs of the parity
+}
+
+double LatticePricer::extrapolated(const Payoff& payoff, bool american, int steps) const
+{
+    double K, B;
+    bool isCall, isUp, isIn;
+    if (payoff.barrier(K, B, isCall, isUp, isIn) && steps >= 1)
+    {
+        steps = std::max(steps, minimumSteps(B)); // Both trees must be fine enough for the barrier
+    }
+    return 2 * price(payoff, american, 2 * steps) - price(payoff, american, steps);
+}
+
+int LatticePricer::minimumSteps(double barrier) const
+{
+    double h = std::abs(std::log(barrier / S0));
+    return static_cast<int>(std::ceil(3 * sigma * sigma * T / (h * h))); // sigma sqrt(3 T / n) <= h
+}
+
+void LatticePricer::intrinsic(const Payoff& payoff, const double* S, double* out, std::size_t n)
+{
+    double K;
+    bool isCall;
+    if (payoff.vanilla(K, isCall))
+    {
+        (isCall ? kernels().callPayoff : kernels().putPayoff)(S, out, n, K);
+        return;
+    }
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        out[k] = payoff(S[k]); // Other payoffs through the virtual call
+    }
+}
+
+double LatticePricer::binomial(const Payoff& payoff, bool american, int steps) const
+{
+    const KernelTable& table = kernels();
+    double dt = T / steps;
+    double u = std::exp(sigma * std::sqrt(dt)), d = 1.0 / u;
+    double growth = std::exp(r * dt);
+    double p = (growth - d) / (u - d); // Risk-neutral probability of an up move
+    if (!(p > 0 && p < 1))
+    {
+        throw std::runtime_error("Binomial probabilities outside (0, 1); increase the number of steps.");
+    }
+
+    std::size_t n = steps;
+    std::vector<double> S(n + 1), V(n + 1), X(american ? n + 1 : 0); // Node prices, node values and intrinsic values
+    for (std::size_t k = 0; k <= n; ++k)
+    {
+        S[k] = S0 * std::exp((2.0 * k - steps) * sigma * std::sqrt(dt));
+    }
+    intrinsic(payoff, S.data(), V.data(), n + 1);
+
+    for (std::size_t i = n; i-- > 0;) // Row i has i + 1 nodes
+    {
+        table.binomialStep(V.data(), i + 1, (1 - p) / growth, p / growth);
+        if (american)
+        {
+            table.scale(S.data(), i + 1, u);
+            intrinsic(payoff, S.data(), X.data(), i + 1);
+            table.runningMax(V.data(), X.data(), i + 1); // Exercise where it beats continuation
+        }
+    }
+    return V[0] * std::exp(r * T);
+}
+
+double LatticePricer::trinomial(const Payoff& payoff, bool american, int steps, double barrier, bool isUp, bool knockOut) const
+{
+    const KernelTable& table = kernels();
+    double dt = T / steps;
+    double nu = r - 0.5 * sigma * sigma; // Drift of log S
+    double dx = sigma * std::sqrt(3 * dt);
+    int m = 0; // Spacings between log(S0) and log(B)
+    if (barrier > 0)
+    {
+        double h = std::abs(std::log(barrier / S0));
+        m = std::max(1, static_cast<int>(std::floor(h / dx)));
+        dx = h / m; // Widen the spacing so that the barrier is a node
+    }
+    double variance = (sigma * sigma * dt + nu * nu * dt * dt) / (dx * dx);
+    double up = 0.5 * (variance + nu * dt / dx), down = 0.5 * (variance - nu * dt / dx), middle = 1 - up - down;
+    if (up < 0 || down < 0 || middle < 0)
+    {
+        throw std::runtime_error("Negative trinomial probability; increase the number of steps.");
+    }
+    double discount = std::exp(-r * dt);
+
+    std::size_t n = steps;
+    std::vector<double> S(2 * n + 1), V(2 * n + 1), X(american ? 2 * n + 1 : 0);
+    for (std::size_t k = 0; k <= 2 * n; ++k)
+    {
+        S[k] = S0 * std::exp((static_cast<double>(k) - steps) * dx); // Maturity row; row i is the window starting at n - i
+    }
+    intrinsic(payoff, S.data(), V.data(), 2 * n + 1);
+
+    auto knock = [&](std::size_t i) // Zero the nodes of row i at or beyond the barrier (node k is at k - i spacings)
+    {
+        if (!knockOut)
+        {
+            return;
+        }
+        std::ptrdiff_t row = 2 * static_cast<std::ptrdiff_t>(i) + 1, first = static_cast<std::ptrdiff_t>(i) + m, last = static_cast<std::ptrdiff_t>(i) - m;
+        if (isUp && first < row)
+        {
+            std::fill(V.begin() + first, V.begin() + row, 0.0);
+        }
+        else if (!isUp && last >= 0)
+        {
+            std::fill(V.begin(), V.begin() + last + 1, 0.0);
+        }
+    };
+    knock(n);
+
+    for (std::size_t i = n; i-- > 0;) // Row i has 2 i + 1 nodes
+    {
+        table.trinomialStep(V.data(), 2 * i + 1, discount * down, discount * middle, discount * up);
+        if (american)
+        {
+            intrinsic(payoff, S.data() + (n - i), X.data(), 2 * i + 1);
+            table.runningMax(V.data(), X.data(), 2 * i + 1);
+        }
+        knock(i);
+    }
+    return V[0] * std::exp(r * T);
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+/*
+ * File: Lattice.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the LatticePricer class, a deterministic tree engine for European, American and barrier options
+ * on a lognormal (GBM) underlying. Backward induction keeps one rolling row of node values, O(N) memory for N steps,
+ * and each step is a batch kernel of the dispatch table that overwrites the row in place at the full vector width;
+ * early exercise is a vector max against the intrinsic values of the row.
+ * The binomial tree is Cox-Ross-Rubinstein. The trinomial tree spaces its log-price nodes so that a barrier falls
+ * exactly on a row of nodes, which removes the sawtooth error of a barrier sitting between nodes; barrier options are
+ * therefore always priced on the trinomial tree, and the barrier is monitored at every step. Knock-in options are
+ * priced as the vanilla minus the knock-out, which only holds for European exercise.
+ * extrapolated() combines the prices of N and 2N steps by Richardson extrapolation, cancelling the first-order error.
+ * Prices are reported in the undiscounted units of the Monte Carlo solver: the discounted tree value times exp(r T).
+ */
+
+#ifndef LATTICE_HPP
+#define LATTICE_HPP
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "SDE.hpp"
+#include "Payoff.hpp"
+
+class LatticePricer
+{
+public:
+    enum class Tree
+    {
+        Binomial, // Cox-Ross-Rubinstein, two branches per node
+        Trinomial // Three branches per node, nodes aligned with the barrier
+    };
+
+private:
+    double r; // Risk-free rate (the drift of the GBM)
+    double sigma; // Volatility
+    double S0; // Initial price
+    double T; // Maturity
+    Tree tree; // Tree used for payoffs without a barrier
+
+    double binomial(const Payoff& payoff, bool american, int steps) const; // Tree value of a payoff without a barrier
+    // Tree value with nodes aligned on barrier (if positive), knocked out at and beyond it if knockOut is set
+    double trinomial(const Payoff& payoff, bool american, int steps, double barrier, bool isUp, bool knockOut) const;
+    int minimumSteps(double barrier) const; // Steps needed to fit one node spacing between S0 and the barrier
+    static void intrinsic(const Payoff& payoff, const double* S, double* out, std::size_t n); // Payoffs of n node prices
+
+public:
+    LatticePricer(std::shared_ptr<SDE> sde, double S0, double T, Tree tree = Tree::Trinomial); // Constructor, needs a GBM
+    double price(const Payoff& payoff, bool american, int steps) const; // Price on a tree of the given number of steps
+    double extrapolated(const Payoff& payoff, bool american, int steps) const; // 2 price(2 steps) - price(steps)
+};
+
+#endif // LATTICE_HPP
\ No newline at end of file
@@ -8,18 +8,48 @@
  * The MCMediator class constructs the MCSolver using the configuration provided by the SimulationBuilder and then
  * runs the Monte Carlo simulation to compute the option price. This class provides a simple and clean interface
  * for setting up and executing Monte Carlo simulations in financial derivative pricing.
+ * The Fourier pricer is built per call: its constructor costs a few hundred characteristic function evaluations,
+ * far less than one block of paths.
  */
 
 #include "MCMediator.hpp"
 #include <tuple>
 
-MCMediator::MCMediator(std::shared_ptr<SimulationBuilder> builder)
+MCMediator::MCMediator(std::shared_ptr<SimulationBuilder> builder, bool fourier)
+    : fourier(fourier)
 {
     auto config = builder->build(); // Get the simulation configuration from the builder
     solver = std::make_shared<MCSolver>(config); // Initialize the Monte Carlo solver with the configuration
+    sde = std::get<0>(config);
+    payoff = std::get<3>(config);
+    S0 = std::get<4>(config);
+    T = std::get<5>(config);
+}
+
+double MCMediator::price(std::shared_ptr<MCSolver> solver, std::shared_ptr<SDE> sde, std::shared_ptr<Payoff> payoff, double S0, double T, bool fourier)
+{
+    if (!fourier || !sde->hasCharacteristicFunction())
+    {
+        return solver->solve(); // Run the simulation and return the computed option price
+    }
+    FourierPricer pricer(sde, S0, T);
+    double K;
+    bool isCall;
+    if (payoff->vanilla(K, isCall))
+    {
+        return pricer.price(K, isCall); // No simulation needed
+    }
+    return solver->solve(std::make_shared<EuropeanCall>(S0), pricer.price(S0, true)); // At-the-money call as the control
 }
 
 double MCMediator::runSimulation()
 {
-    return solver->solve(); // Run the simulation and return the computed option price
+    return price(solver, sde, payoff, S0, T, fourier);
+}
+
+std::future<double> MCMediator::runSimulationAsync(const Schedule& schedule)
+{
+    // Keep the solver and the model alive until the task has run; its chunks inherit the schedule as nested tasks
+    return ThreadPool::instance().submit([job = solver, sde = sde, payoff = payoff, S0 = S0, T = T, fourier = fourier]()
+        { return price(job, sde, payoff, S0, T, fourier); }, schedule);
 }
\ No newline at end of file
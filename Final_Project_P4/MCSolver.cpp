@@ -8,9 +8,40 @@
  * and compute option prices. The solver uses numerical methods (FDM) to advance the solution of the SDE, random number generation (RNG)
  * to simulate Wiener process increments, and payoff functions to calculate the option value based on the simulated price paths.
  * The class supports both standard options (e.g., European options) and path-dependent options (e.g., Asian options).
+ * Both the plain and the control-variate estimators reduce per-chunk sums with the same accumulate() loop, so they
+ * split the paths and draw the random numbers identically.
+ * The standard error of a ratio of sums over B blocks is estimated by the delta method from the residuals
+ * S_b - price n_b of the block sums S_b and accepted counts n_b; their sum of squares expands into sums of products
+ * of S_b and n_b, which are additive across chunks like every other sum.
  */
 
 #include "MCSolver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+// Standard error of sum(S_b) / accepted from the sum of squared block residuals over the given number of blocks
+static double batchError(double residuals, double accepted, double blocks)
+{
+    if (blocks < 2)
+    {
+        return std::numeric_limits<double>::quiet_NaN(); // One batch carries no estimate of its own spread
+    }
+    return std::sqrt(std::max(residuals, 0.0) * blocks / (blocks - 1)) / accepted;
+}
+
+static std::atomic<bool> reproducibleMode{ false }; // Set by setReproducible()
+
+void MCSolver::setReproducible(bool on)
+{
+    reproducibleMode.store(on, std::memory_order_relaxed);
+}
+
+bool MCSolver::reproducible()
+{
+    return reproducibleMode.load(std::memory_order_relaxed);
+}
 
 MCSolver::MCSolver(const std::tuple<std::shared_ptr<SDE>, std::shared_ptr<FDM>, std::shared_ptr<RNG>, std::shared_ptr<Payoff>, double, double, int, int>& config)
     : sde(std::get<0>(config)), // Initialize SDE
@@ -34,41 +65,247 @@ MCSolver::MCSolver(const std::tuple<std::shared_ptr<SDE>, std::shared_ptr<FDM>,
 }
 
 double MCSolver::solve()
+{
+    return solve(std::vector<std::shared_ptr<Payoff>>{ payoff }, std::vector<int>{ M })[0];
+}
+
+std::vector<double> MCSolver::solve(const std::vector<std::shared_ptr<Payoff>>& payoffs, const std::vector<int>& paths)
+{
+    std::vector<double> prices(payoffs.size());
+    solve(payoffs, paths, prices.data());
+    return prices;
+}
+
+void MCSolver::solve(const std::vector<std::shared_ptr<Payoff>>& payoffs, const std::vector<int>& paths, double* prices)
 {
     double dt = T / N; // Time step size
     if (dt <= 0)
     {
         throw std::runtime_error("Time step (dt) must be positive.");
     }
+    if (payoffs.empty() || payoffs.size() != paths.size())
+    {
+        throw std::invalid_argument("Each payoff needs a matching number of simulations.");
+    }
+    for (std::size_t k = 0; k < payoffs.size(); ++k)
+    {
+        if (!payoffs[k] || paths[k] <= 0)
+        {
+            throw std::invalid_argument("Payoffs must be non-null and simulation counts positive.");
+        }
+    }
+
+    std::size_t K = payoffs.size();
+    int total = *std::max_element(paths.begin(), paths.end()); // Shared paths needed by the largest job
+    std::vector<double> sums(6 * K, 0.0); // Accumulated payoff sums, accepted path counts and block statistics
+    std::vector<double> dates = observationDates(payoffs); // Empty unless the paths can be sampled on sparse dates
+    if (dates.empty() && sde->simulatesPaths())
+    {
+        sde->calibrate(S0, T, N, rng); // Fit grid-dependent model state once, before the chunks share it
+    }
+
+    accumulate(total, 6 * K, [&](std::shared_ptr<RNG> generator, int first, int count, double* chunkSums)
+    {
+        sumPayoffs(generator, first, count, payoffs, paths, dates, chunkSums);
+    }, sums.data());
+
+    for (std::size_t k = 0; k < K; ++k)
+    {
+        if (sums[K + k] == 0)
+        {
+            throw std::runtime_error("Every simulated path was rejected by the boundary policy.");
+        }
+    }
+
+    errors.assign(K, 0.0);
+    for (std::size_t k = 0; k < K; ++k)
+    {
+        double price = sums[k] / sums[K + k]; // Average payoff over the accepted paths (option price)
+        double residuals = sums[2 * K + k] - 2 * price * sums[3 * K + k] + price * price * sums[4 * K + k];
+        errors[k] = batchError(residuals, sums[K + k], sums[5 * K + k]);
+        prices[k] = price;
+    }
+}
+
+double MCSolver::solve(std::shared_ptr<Payoff> control, double controlMean)
+{
+    if (!control)
+    {
+        throw std::invalid_argument("Control payoff is null.");
+    }
+    double sums[12] = {}; // Sums of y, x, x y, x^2 and the number of accepted paths, then the block statistics
+    std::vector<double> dates = observationDates({ payoff, control }); // Both payoffs are evaluated on the same paths
+    if (dates.empty() && sde->simulatesPaths())
+    {
+        sde->calibrate(S0, T, N, rng);
+    }
+
+    accumulate(M, 12, [&](std::shared_ptr<RNG> generator, int first, int count, double* chunkSums)
+    {
+        sumControlled(generator, count, *control, dates, chunkSums);
+    }, sums);
+
+    double n = sums[4];
+    if (n == 0)
+    {
+        throw std::runtime_error("Every simulated path was rejected by the boundary policy.");
+    }
+    double meanY = sums[0] / n, meanX = sums[1] / n;
+    double covariance = sums[2] - n * meanX * meanY;
+    double variance = sums[3] - n * meanX * meanX;
+    double beta = variance > 0 ? covariance / variance : 0.0; // Regression coefficient of the payoff on the control
+    double price = meanY - beta * (meanX - controlMean);
+
+    // The residual of a block is u . (Sy, Sx, n) with u = (1, -beta, beta controlMean - price)
+    double u[3] = { 1.0, -beta, beta * controlMean - price };
+    const double* g = sums + 5; // yy, yx, yn, xx, xn, nn
+    double residuals = u[0] * u[0] * g[0] + u[1] * u[1] * g[3] + u[2] * u[2] * g[5]
+        + 2 * (u[0] * u[1] * g[1] + u[0] * u[2] * g[2] + u[1] * u[2] * g[4]);
+    errors.assign(1, batchError(residuals, n, sums[11]));
+    return price;
+}
+
+double MCSolver::standardError() const
+{
+    return errors.empty() ? std::numeric_limits<double>::quiet_NaN() : errors[0];
+}
+
+const std::vector<double>& MCSolver::standardErrors() const
+{
+    return errors;
+}
+
+void MCSolver::setPathCache(std::shared_ptr<PathCache> cache)
+{
+    this->cache = cache;
+}
+
+PathGenerator MCSolver::producer(std::shared_ptr<RNG> generator, int count, const std::vector<double>& dates) const
+{
+    PathGenerator paths = !dates.empty() ? PathGenerator(sde, generator, S0, dates, count) // Sample only the observation dates exactly
+        : sde->simulatesPaths() ? PathGenerator(sde, generator, S0, T, N, count) // Let the model fill whole paths
+        : PathGenerator(fdm, generator, S0, T, N, count); // Step the FDM scheme through the full grid
+    paths.setFixedWidth(reproducible()); // The last block of a chunk is then drawn as if more paths followed
+    if (cache && generator != rng) // Only a fresh stream is at the start of the sequence its key describes
+    {
+        paths.useCache(cache);
+    }
+    return paths;
+}
+
+void MCSolver::accumulate(int total, std::size_t width, const std::function<void(std::shared_ptr<RNG>, int, int, double*)>& body, double* sums) const
+{
+    if (!rng->stream(0))
+    {
+        body(rng, 0, total, sums); // The RNG cannot be split: simulate every path on this thread
+        return;
+    }
 
-    double sum = 0.0; // Accumulator for payoff values
-    for (int i = 0; i < M; ++i) // Loop over Monte Carlo simulations
+    int chunks = (total + chunkPaths - 1) / chunkPaths; // Fixed chunk size, independent of the number of threads
+    std::uint64_t epoch = rng->nextEpoch(); // Ours alone: later and concurrent solves draw from other streams
+    ThreadPool::instance().parallelSum(chunks, width, [&](std::size_t c, double* chunkSums)
     {
-        double S = S0; // Initialize asset price
-        std::vector<double> path(N + 1); // Store the price path for path-dependent options
-        path[0] = S0; // Set initial price
+        int first = static_cast<int>(c) * chunkPaths;
+        int count = std::min(chunkPaths, total - first);
+        body(rng->stream(c, epoch), first, count, chunkSums); // Each chunk draws from its own stream
+    }, sums); // Combined in a fixed tree order, so the result does not depend on scheduling
+}
 
-        for (int j = 0; j < N; ++j) // Loop over time steps
+std::vector<double> MCSolver::observationDates(const std::vector<std::shared_ptr<Payoff>>& payoffs) const
+{
+    if (!fdm->samplesDates() || !sde->hasExactTransition())
+    {
+        return {}; // The chosen scheme is stepped through the full grid
+    }
+
+    std::vector<double> dates;
+    for (const auto& p : payoffs)
+    {
+        std::vector<double> observed = p->observationTimes(T);
+        if (observed.empty())
         {
-            double dW = std::sqrt(dt) * rng->generate(); // Generate Wiener process increment
-            S = fdm->advance(S, j * dt, dt, dW); // Advance the solution using FDM
-            if (S < 0)
+            return {}; // At least one payoff needs every step
+        }
+        dates.insert(dates.end(), observed.begin(), observed.end());
+    }
+    std::sort(dates.begin(), dates.end());
+    dates.erase(std::unique(dates.begin(), dates.end()), dates.end()); // Union of all observation dates
+
+    if (dates.front() <= 0 || dates.back() > T * (1 + 1e-12)) // Tolerate rounding in dates computed from T
+    {
+        throw std::invalid_argument("Observation dates must lie in (0, T].");
+    }
+    return dates;
+}
+
+void MCSolver::sumPayoffs(std::shared_ptr<RNG> generator, int first, int count, const std::vector<std::shared_ptr<Payoff>>& payoffs,
+    const std::vector<int>& paths, const std::vector<double>& dates, double* sums) const
+{
+    PathGenerator source = producer(generator, count, dates);
+    std::vector<double> values(PathGenerator::defaultBlockSize); // Payoffs of the current block
+    std::size_t K = payoffs.size();
+    int start = first; // Global index of the first path in the current block
+
+    for (const PathBlock& block : source.blocks()) // Pull one block of paths at a time
+    {
+        const std::uint8_t* rejected = block.rejected();
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            int used = std::clamp(paths[k] - start, 0, static_cast<int>(block.size())); // Paths of this block that belong to job k
+            if (used == 0)
             {
-                throw std::runtime_error("Negative asset price encountered during simulation.");
+                continue;
             }
-            path[j + 1] = S; // Store the price at the current time step
+            payoffs[k]->evaluateBlock(block, values.data()); // Path-dependent payoffs use the full paths, others the terminal prices
+            double total = 0, accepted = 0;
+            for (int p = 0; p < used; ++p)
+            {
+                double keep = 1.0 - rejected[p]; // Branch-free: rejected paths contribute nothing
+                total += keep * values[p];
+                accepted += keep;
+            }
+            sums[k] += total;
+            sums[K + k] += accepted;
+            sums[2 * K + k] += total * total; // One batch per block for the standard error
+            sums[3 * K + k] += total * accepted;
+            sums[4 * K + k] += accepted * accepted;
+            sums[5 * K + k] += 1;
         }
+        start += static_cast<int>(block.size());
+    }
+}
+
+void MCSolver::sumControlled(std::shared_ptr<RNG> generator, int count, const Payoff& control, const std::vector<double>& dates, double* sums) const
+{
+    PathGenerator source = producer(generator, count, dates);
+    std::vector<double> y(PathGenerator::defaultBlockSize), x(PathGenerator::defaultBlockSize); // Payoffs and controls of the current block
 
-        // Calculate payoff based on the option type
-        if (auto asianPayoff = std::dynamic_pointer_cast<AsianOption>(payoff))
+    for (const PathBlock& block : source.blocks())
+    {
+        const std::uint8_t* rejected = block.rejected();
+        payoff->evaluateBlock(block, y.data());
+        control.evaluateBlock(block, x.data());
+        double b[5] = {}; // Sums of y, x, x y, x^2 and the accepted count over this block
+        for (std::size_t p = 0; p < block.size(); ++p)
         {
-            sum += (*payoff)(path); // Use the entire price path for Asian options
+            double keep = 1.0 - rejected[p]; // Branch-free: rejected paths contribute nothing
+            b[0] += keep * y[p];
+            b[1] += keep * x[p];
+            b[2] += keep * x[p] * y[p];
+            b[3] += keep * x[p] * x[p];
+            b[4] += keep;
         }
-        else
+        for (int k = 0; k < 5; ++k)
         {
-            sum += (*payoff)(S); // Use the final price for standard options
+            sums[k] += b[k];
         }
+        double v[3] = { b[0], b[1], b[4] }; // Block sums of y and x and the accepted count
+        sums[5] += v[0] * v[0];
+        sums[6] += v[0] * v[1];
+        sums[7] += v[0] * v[2];
+        sums[8] += v[1] * v[1];
+        sums[9] += v[1] * v[2];
+        sums[10] += v[2] * v[2];
+        sums[11] += 1;
     }
-
-    return sum / M; // Return the average payoff (option price)
 }
\ No newline at end of file
@@ -8,18 +8,41 @@
  * using the Monte Carlo method. The class integrates components for stochastic modeling (SDE), numerical methods (FDM), random number
  * generation (RNG), and payoff calculations (Payoff) to simulate asset price paths and compute option prices.
  * The solver is designed to handle both standard and path-dependent options, making it a versatile tool for financial derivative pricing.
+ * Paths are split into fixed-size chunks that run on the process-wide ThreadPool whenever the RNG can be split into streams.
+ * When the scheme is ExactTransition and every payoff only observes a few dates, the solver samples those dates
+ * directly instead of stepping through all N time steps; with any other scheme it always steps the full grid.
+ * Paths rejected by the SDE's Reject boundary policy are left out, and each price is averaged over the accepted paths.
+ * A control payoff with a known price (for example a European option priced by the Fourier engine) can be simulated
+ * on the same paths; the regression-adjusted estimate removes the part of the noise the two payoffs share. The known
+ * price must be the mean of the control under the simulated paths: any discretisation bias of the control enters
+ * the estimate, scaled by the coefficient.
+ * Standard errors are computed by batch means, one batch per block of paths: paths of a block are not independent
+ * once the RNG moment-matches its normals across the block, but the blocks themselves still are.
+ * With a PathCache set, the paths of every chunk drawn from its own stream are shared with other processes that
+ * simulate the same chunk; a single-threaded run of an RNG without streams never uses the cache.
+ * Every solve claims a stream epoch of its own when it starts, so repeated solves, and solves running at the same
+ * time on one RNG, draw new paths; a new RNG with the same seed repeats a sequence of solves in the same order.
+ * Prices never depend on the number of threads: chunks have a fixed size, each draws from the stream of its index,
+ * and chunk sums are added in a fixed tree order. In reproducible mode a path also never depends on the number of
+ * paths requested, since partial blocks are simulated at full width: path i is a function of the seed and i alone,
+ * and a job fused with larger jobs by the SimulationQueue prices exactly as it would on its own.
  */
 
 #ifndef MCSOLVER_HPP
 #define MCSOLVER_HPP
 
+#include <functional>
 #include <memory>
 #include <tuple>
+#include <vector>
 #include <stdexcept>
 #include "SDE.hpp"
 #include "FDM.hpp"
 #include "RNG.hpp"
 #include "Payoff.hpp"
+#include "PathGenerator.hpp"
+#include "PathCache.hpp"
+#include "ThreadPool.hpp"
 
 class MCSolver
 {
@@ -32,10 +55,45 @@ private:
     double T;  // Maturity (time to expiration)
     int N;     // Number of time steps
     int M;     // Number of Monte Carlo simulations
+    std::vector<double> errors; // Batched standard errors of the prices of the last solve
+    std::shared_ptr<PathCache> cache; // Shared store of simulated chunks (null if not used)
+
+    std::vector<double> observationDates(const std::vector<std::shared_ptr<Payoff>>& payoffs) const; // Sparse dates to simulate (empty for the full grid)
+    PathGenerator producer(std::shared_ptr<RNG> generator, int count, const std::vector<double>& dates) const; // Generator of count paths for one chunk
+
+    // Run body(generator, first, count, sums) over paths [0, total) in fixed-size chunks, on the pool when the RNG can be
+    // split, and add the width sums of every chunk to sums in a fixed tree order
+    void accumulate(int total, std::size_t width, const std::function<void(std::shared_ptr<RNG>, int, int, double*)>& body, double* sums) const;
+
+    // Simulate paths [first, first + count) with one generator and add each payoff's sum over its own first paths[k] paths to sums[k],
+    // and the number of those paths that were not rejected to sums[K + k]. For the standard errors, with S and n the sum and
+    // the accepted count of a block, add the sums of S^2, S n and n^2 over the blocks to sums[2K + k], sums[3K + k] and
+    // sums[4K + k], and the number of blocks to sums[5K + k]
+    void sumPayoffs(std::shared_ptr<RNG> generator, int first, int count, const std::vector<std::shared_ptr<Payoff>>& payoffs,
+        const std::vector<int>& paths, const std::vector<double>& dates, double* sums) const;
+
+    // Simulate count paths and add the sums of y, x, x y and x^2 over the accepted paths, then their number, to sums[0..5)
+    // (y: the payoff, x: the control); then, over the blocks, the sums of the products of the block sums of y and x and the
+    // block's accepted count (yy, yx, yn, xx, xn, nn) to sums[5..11) and the number of blocks to sums[11]
+    void sumControlled(std::shared_ptr<RNG> generator, int count, const Payoff& control, const std::vector<double>& dates, double* sums) const;
 
 public:
+    static constexpr int chunkPaths = 16384; // Paths per parallel task
+
+    static void setReproducible(bool on); // Process-wide: make every path depend only on the seed and its index
+    static bool reproducible(); // Whether reproducible mode is on
+
     MCSolver(const std::tuple<std::shared_ptr<SDE>, std::shared_ptr<FDM>, std::shared_ptr<RNG>, std::shared_ptr<Payoff>, double, double, int, int>& config); // Constructor
     double solve(); // Solve the SDE and compute the option price
+    // Price several payoffs on one set of simulated paths; payoff k is averaged over the first paths[k] paths
+    std::vector<double> solve(const std::vector<std::shared_ptr<Payoff>>& payoffs, const std::vector<int>& paths);
+    // Same, writing price k to prices[k]; nothing is written if the solve fails
+    void solve(const std::vector<std::shared_ptr<Payoff>>& payoffs, const std::vector<int>& paths, double* prices);
+    // Price the payoff with control as a control variate whose exact price is controlMean (coefficient estimated on the same paths)
+    double solve(std::shared_ptr<Payoff> control, double controlMean);
+    void setPathCache(std::shared_ptr<PathCache> cache); // Share simulated chunks through cache (null to stop)
+    double standardError() const; // Standard error of the (first) price of the last solve
+    const std::vector<double>& standardErrors() const; // Standard errors of every price of the last solve
 };
 
 #endif // MCSOLVER_HPP
\ No newline at end of file
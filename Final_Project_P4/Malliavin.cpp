@@ -0,0 +1,185 @@
+/*
+ * File: Malliavin.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the MalliavinSolver class. Prices, the first variation Y = dS/dS0 and the vega variation
+ * V = dS/d(shift) are stepped together, every row holding all paths of a block:
+ *     S' = S + a dt + b dW,   Y' = Y (1 + a_S dt + b_S dW),   V' = V (1 + a_S dt + b_S dW) + S dW
+ * with a_S and b_S central differences of the drift and the diffusion. For a payoff observed at maturity only, the
+ * vega weight also needs how beta = V / Y moves when every Z_j moves by u_j; this is one more tangent pass through
+ * S, Y and V, using second differences of the drift and the diffusion. For each path the estimators are
+ *     delta = sum_j g_j Y_j + (f - g) * delta weight,   vega = sum_j g_j V_j + (f - g) * vega weight
+ * where f is the payoff, g its localised smooth part and g_j the derivative of g with respect to the j-th price.
+ */
+
+#include "Malliavin.hpp"
+#include "MCSolver.hpp"
+#include "PathBlock.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+
+MalliavinSolver::MalliavinSolver(std::shared_ptr<SDE> sde, std::shared_ptr<RNG> rng, std::shared_ptr<Payoff> payoff, double S0, double T, int N, int M,
+    double width)
+    : sde(sde), rng(rng), payoff(payoff), S0(S0), T(T), N(N), M(M), width(width)
+{
+    if (!sde || !rng || !payoff)
+    {
+        throw std::invalid_argument("One or more components (SDE, RNG, Payoff) are null.");
+    }
+    if (S0 <= 0 || T <= 0 || N <= 0 || M <= 1 || width <= 0)
+    {
+        throw std::invalid_argument("Initial conditions (S0, T, N, M) and the localisation width must be positive.");
+    }
+    if (sde->simulatesPaths())
+    {
+        throw std::invalid_argument("Malliavin weights need a model given by its drift and diffusion.");
+    }
+}
+
+void MalliavinSolver::sumPaths(RNG& generator, int count, double* sums) const
+{
+    double dt = T / N;
+    double sqrtDt = std::sqrt(dt);
+    std::vector<double> dates = payoff->observationTimes(T);
+    bool terminal = dates.size() == 1 && std::abs(dates[0] - T) <= 1e-12 * T; // Maturity only: Malliavin vega weight
+    int horizon = dates.empty() ? 1 : std::max(1, static_cast<int>(std::round(dates.front() / dt))); // Steps before the first observed date
+    double band = width * S0;
+
+    std::vector<double> times(N + 1);
+    for (int j = 0; j <= N; ++j)
+    {
+        times[j] = j * dt;
+    }
+    PathBlock block(blockSize, times);
+    std::vector<double> Y((N + 1) * blockSize), V((N + 1) * blockSize); // Variations, stored like the block rows
+    std::vector<double> Z(blockSize), values(blockSize);
+    std::vector<double> deltaWeight(blockSize), vegaWeight(blockSize);
+    std::vector<double> dS(blockSize), dY(blockSize), dV(blockSize); // Tangents of S, Y and V along the direction q
+    std::vector<double> path, gradient;
+
+    for (int first = 0; first < count; first += static_cast<int>(blockSize))
+    {
+        std::size_t n = std::min<std::size_t>(blockSize, count - first);
+        block.resize(n);
+        std::fill(block.row(0), block.row(0) + n, S0);
+        std::fill(Y.begin(), Y.begin() + n, 1.0);
+        std::fill(V.begin(), V.begin() + n, 0.0);
+        std::fill(deltaWeight.begin(), deltaWeight.begin() + n, 0.0);
+        std::fill(vegaWeight.begin(), vegaWeight.begin() + n, 0.0);
+        std::fill(dS.begin(), dS.begin() + n, 0.0);
+        std::fill(dY.begin(), dY.begin() + n, 0.0);
+        std::fill(dV.begin(), dV.begin() + n, 0.0);
+
+        for (int j = 0; j < N; ++j)
+        {
+            generator.generateBlock(Z.data(), n);
+            const double* S = block.row(j);
+            double* next = block.row(j + 1);
+            const double* y = &Y[j * blockSize];
+            const double* v = &V[j * blockSize];
+            double* yNext = &Y[(j + 1) * blockSize];
+            double* vNext = &V[(j + 1) * blockSize];
+            double t = j * dt;
+            for (std::size_t p = 0; p < n; ++p)
+            {
+                double h = bump * std::max(1.0, std::abs(S[p]));
+                double a = sde->drift(S[p], t), aUp = sde->drift(S[p] + h, t), aDown = sde->drift(S[p] - h, t);
+                double b = sde->diffusion(S[p], t), bUp = sde->diffusion(S[p] + h, t), bDown = sde->diffusion(S[p] - h, t);
+                if (!(b > 0))
+                {
+                    throw std::runtime_error("Malliavin weights need a positive diffusion along the path.");
+                }
+                double aS = (aUp - aDown) / (2 * h), bS = (bUp - bDown) / (2 * h);
+                double dW = sqrtDt * Z[p];
+                double growth = 1.0 + aS * dt + bS * dW;
+
+                next[p] = S[p] + a * dt + b * dW;
+                yNext[p] = y[p] * growth;
+                vNext[p] = v[p] * growth + S[p] * dW; // The shift adds S to the diffusion
+                if (j < horizon)
+                {
+                    deltaWeight[p] += Z[p] * yNext[p] / (b * sqrtDt) - y[p] * bS / b; // Z_j u_j - du_j/dZ_j
+                }
+
+                if (terminal)
+                {
+                    // Perturb every Z_j by q_j = u_j and carry the derivatives of S, Y and V (second differences for a'' and b'')
+                    double q = yNext[p] / (b * sqrtDt * N);
+                    double aSS = (aUp - 2 * a + aDown) / (h * h), bSS = (bUp - 2 * b + bDown) / (h * h);
+                    double dGrowth = (aSS * dt + bSS * dW) * dS[p] + bS * sqrtDt * q;
+                    dV[p] = dV[p] * growth + v[p] * dGrowth + dS[p] * dW + S[p] * sqrtDt * q;
+                    dY[p] = dY[p] * growth + y[p] * dGrowth;
+                    dS[p] = dS[p] * growth + b * sqrtDt * q;
+                }
+                else
+                {
+                    vegaWeight[p] += S[p] / b * (Z[p] * Z[p] - 1.0); // Score of the Euler step for b -> b + shift * S
+                }
+            }
+        }
+
+        const double* yN = &Y[N * blockSize];
+        const double* vN = &V[N * blockSize];
+        for (std::size_t p = 0; p < n; ++p)
+        {
+            deltaWeight[p] /= horizon;
+            if (terminal)
+            {
+                double beta = vN[p] / yN[p]; // Vega variation in units of the delta variation
+                double dBeta = dV[p] / yN[p] - vN[p] * dY[p] / (yN[p] * yN[p]);
+                vegaWeight[p] = beta * deltaWeight[p] - dBeta;
+            }
+        }
+
+        payoff->evaluateBlock(block, values.data());
+        for (std::size_t p = 0; p < n; ++p)
+        {
+            block.copyPath(p, path);
+            double smooth = payoff->localised(path, band, gradient);
+            double delta = 0.0, vega = 0.0;
+            for (int j = 0; j <= N; ++j)
+            {
+                if (gradient[j] != 0.0) // Most points have no influence on the smooth part
+                {
+                    delta += gradient[j] * Y[j * blockSize + p];
+                    vega += gradient[j] * V[j * blockSize + p];
+                }
+            }
+            double remainder = values[p] - smooth; // Zero away from the discontinuities
+            delta += remainder * deltaWeight[p];
+            vega += remainder * vegaWeight[p];
+
+            sums[0] += values[p];
+            sums[1] += values[p] * values[p];
+            sums[2] += delta;
+            sums[3] += delta * delta;
+            sums[4] += vega;
+            sums[5] += vega * vega;
+        }
+    }
+}
+
+WeightedGreeks MalliavinSolver::solve()
+{
+    std::vector<double> sums(6, 0.0);
+    if (!rng->stream(0))
+    {
+        sumPaths(*rng, M, sums.data()); // The RNG cannot be split: simulate every path on this thread
+    }
+    else
+    {
+        int chunks = (M + MCSolver::chunkPaths - 1) / MCSolver::chunkPaths;
+        ThreadPool::instance().parallelSum(chunks, 6, [&](std::size_t c, double* chunkSums)
+        {
+            int count = std::min(MCSolver::chunkPaths, M - static_cast<int>(c) * MCSolver::chunkPaths);
+            sumPaths(*rng->stream(c), count, chunkSums); // Each chunk draws from its own stream
+        }, sums.data()); // Combined in a fixed tree order, so the result does not depend on scheduling
+    }
+
+    auto mean = [&](int k) { return sums[k] / M; };
+    auto error = [&](int k) { return std::sqrt(std::max(sums[k + 1] / M - mean(k) * mean(k), 0.0) / (M - 1)); };
+    return { mean(0), error(0), mean(2), error(2), mean(4), error(4) };
+}
\ No newline at end of file
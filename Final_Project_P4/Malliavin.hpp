@@ -0,0 +1,70 @@
+/*
+ * File: Malliavin.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the MalliavinSolver class, which prices a payoff together with its delta and vega when the
+ * payoff is discontinuous (digital and barrier options), where pathwise derivatives are wrong and bumped prices are
+ * very noisy. Both Greeks are expectations of the payoff times a weight accumulated along the path in the same pass
+ * as the price. The weights come from integrating by parts against the Gaussian increments of the Euler scheme
+ * (Malliavin calculus on the discrete path), so they are exact for the simulated scheme:
+ *     delta weight  sum over the steps before the first observed date of Z_j u_j - du_j/dZ_j,
+ *                   with u_j = Y_(j+1) / (b(S_j) sqrt(dt) * number of those steps)
+ *     vega weight   beta * delta weight - (derivative of beta along u), with beta = V / Y at maturity
+ * where b is the diffusion, Y = dS/dS0 and V = dS/d(shift) the variation processes, and vega is the sensitivity to
+ * a parallel shift of the local volatility b(S, t) / S (the usual vega under GBM). The vega weight needs a payoff
+ * observed at maturity only; for other payoffs the likelihood ratio of the whole Euler path is used instead, whose
+ * variance grows with the number of steps.
+ * The weights are only applied to the localised part of the payoff: Payoff::localised() supplies a smooth part that
+ * is differentiated pathwise along the first variation processes, and the remainder vanishes away from the strike
+ * and the barrier, which removes most of the variance of the weights.
+ * Paths follow the Euler scheme on the full grid, in blocks of paths stored row by row, and run in parallel chunks.
+ * Like MCSolver, the results are not discounted.
+ */
+
+#ifndef MALLIAVIN_HPP
+#define MALLIAVIN_HPP
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "SDE.hpp"
+#include "RNG.hpp"
+#include "Payoff.hpp"
+
+struct WeightedGreeks
+{
+    double price; // Average payoff
+    double priceError; // Standard error of the price
+    double delta; // Derivative of the price with respect to S0
+    double deltaError; // Standard error of the delta
+    double vega; // Derivative of the price with respect to a parallel shift of the local volatility
+    double vegaError; // Standard error of the vega
+};
+
+class MalliavinSolver
+{
+private:
+    std::shared_ptr<SDE> sde; // Diffusion model of the underlying
+    std::shared_ptr<RNG> rng; // Random Number Generator
+    std::shared_ptr<Payoff> payoff; // Payoff, split by its localised() method
+    double S0; // Initial stock price
+    double T;  // Maturity (time to expiration)
+    int N;     // Number of time steps
+    int M;     // Number of Monte Carlo simulations
+    double width; // Half-width of the localisation band, as a fraction of S0
+
+    void sumPaths(RNG& generator, int count, double* sums) const; // Add the sums and sums of squares of the three estimators over count paths
+
+public:
+    static constexpr std::size_t blockSize = 256; // Paths simulated together
+    static constexpr double bump = 1e-4; // Relative step of the finite differences of drift and diffusion
+
+    MalliavinSolver(std::shared_ptr<SDE> sde, std::shared_ptr<RNG> rng, std::shared_ptr<Payoff> payoff, double S0, double T, int N, int M,
+        double width = 0.05); // Constructor
+    WeightedGreeks solve(); // Price, delta and vega with their standard errors
+};
+
+#endif // MALLIAVIN_HPP
\ No newline at end of file
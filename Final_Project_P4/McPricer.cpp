@@ -0,0 +1,441 @@
+/*
+ * File: McPricer.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the C interface of McPricer.h on top of SimulationBuilder and MCSolver. A configuration
+ * handle owns a SimulationBuilder and rebuilds the scheme whenever the model changes, as selectFDM() does; every
+ * setter also refreshes the built configuration the handle keeps, so a batch does not build it again. A batch
+ * becomes one multi-payoff solve, exactly like a fused SimulationQueue group, so every trade of a batch is priced
+ * on the same paths, and the solver writes the prices straight into the caller's array. The handle keeps the payoff
+ * of every distinct trade it has priced, and the payoff and path-count vectors handed to the solver are scratch that
+ * is kept between calls (per thread for mc_price_batch, per job for mc_submit_batch), so repeating a batch neither
+ * builds payoffs nor reallocates.
+ * No exception crosses the C boundary: each entry point translates them into a status code and keeps the message
+ * for mc_last_error() or mc_job_error().
+ */
+
+#define MCPRICER_BUILD
+#include "McPricer.h"
+#include "SimulationBuilder.hpp"
+#include "SimulationQueue.hpp"
+#include "MCSolver.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using TradeKey = std::tuple<int32_t, bool, double, double>; // Payoff kind, call flag, strike and barrier of a trade
+
+struct mc_config
+{
+    SimulationBuilder builder; // Components and initial condition, as set through the C setters
+    int32_t model = MC_MODEL_GBM; // Current model and its parameters
+    std::vector<double> parameters{ 0.05, 0.2 }; // Same defaults as the interactive builder
+    mc_scheme scheme = MC_SCHEME_EULER; // Current scheme
+    Boundary boundary = Boundary::Absorb; // Current boundary policy
+    SimulationQueue::Config built; // Result of builder.build(), refreshed by every setter once the configuration is complete
+    bool complete = false; // Whether the initial condition has been set, so that built is valid
+    mutable std::mutex payoffMutex; // Guards payoffs, since batches on one configuration may run concurrently
+    mutable std::map<TradeKey, std::shared_ptr<Payoff>> payoffs; // Payoff of every distinct trade priced so far
+};
+
+struct Scratch
+{
+    std::vector<std::shared_ptr<Payoff>> payoffs; // Payoff of every trade
+    std::vector<int> paths; // Paths averaged by every trade
+};
+
+struct mc_job
+{
+    SimulationQueue::Config config; // Snapshot taken at submission, so the configuration may change or be destroyed
+    double* prices; // Caller's output array
+    mc_callback done; // Completion callback (may be null)
+    void* context; // Passed back to done
+    Scratch scratch; // Payoffs of the trades, built at submission
+    std::string error; // Message of a failed job
+    std::atomic<mc_status> status{ MC_PENDING }; // Final status once the job has finished
+    std::future<void> finished; // Ready when the job has finished
+};
+
+static thread_local std::string lastError; // Message of the last failure on this thread
+static thread_local Scratch batchScratch; // Reused by every mc_price_batch() call of this thread
+static constexpr std::size_t payoffCacheLimit = 4096; // Distinct trades a configuration keeps before starting over
+
+static mc_status fail(mc_status status, const char* message)
+{
+    lastError = message;
+    return status;
+}
+
+// Run body and translate any exception into a status code and the thread's last error
+template <typename F>
+static mc_status guarded(F body)
+{
+    try
+    {
+        body();
+        lastError.clear();
+        return MC_OK;
+    }
+    catch (const std::invalid_argument& e)
+    {
+        return fail(MC_INVALID_ARGUMENT, e.what());
+    }
+    catch (const std::out_of_range& e)
+    {
+        return fail(MC_INVALID_ARGUMENT, e.what());
+    }
+    catch (const std::exception& e)
+    {
+        return fail(MC_RUNTIME_ERROR, e.what());
+    }
+    catch (...)
+    {
+        return fail(MC_RUNTIME_ERROR, "Unknown error.");
+    }
+}
+
+static std::shared_ptr<SDE> makeModel(int32_t model, const double* p, std::size_t count)
+{
+    static const std::size_t parameters[] = { 2, 3, 3, 5, 4, 4, 6, 5 }; // Parameter count of every mc_model
+    if (model < 0 || model > MC_MODEL_MERTON)
+    {
+        throw std::invalid_argument("Unknown model.");
+    }
+    if (!p || count != parameters[model])
+    {
+        throw std::invalid_argument("Wrong number of model parameters.");
+    }
+    switch (model)
+    {
+    case MC_MODEL_GBM:
+        return std::make_shared<GBM>(p[0], p[1]);
+    case MC_MODEL_CEV:
+        return std::make_shared<CEV>(p[0], p[1], p[2]);
+    case MC_MODEL_CIR:
+        return std::make_shared<CIR>(p[0], p[1], p[2]);
+    case MC_MODEL_ROUGH_BERGOMI:
+        return std::make_shared<RoughBergomi>(p[0], p[1], p[2], p[3], p[4]);
+    case MC_MODEL_VARIANCE_GAMMA:
+        return std::make_shared<VarianceGamma>(p[0], p[1], p[2], p[3]);
+    case MC_MODEL_NIG:
+        return std::make_shared<NormalInverseGaussian>(p[0], p[1], p[2], p[3]);
+    case MC_MODEL_HESTON:
+        return std::make_shared<Heston>(p[0], p[1], p[2], p[3], p[4], p[5]);
+    default:
+        return std::make_shared<MertonJumpDiffusion>(p[0], p[1], p[2], p[3], p[4]);
+    }
+}
+
+static std::shared_ptr<FDM> makeScheme(mc_scheme scheme, std::shared_ptr<SDE> sde)
+{
+    switch (scheme)
+    {
+    case MC_SCHEME_MILSTEIN:
+        return std::make_shared<MilsteinMethod>(sde);
+    case MC_SCHEME_PREDICTOR_CORRECTOR:
+        return std::make_shared<DriftAdjustedPredictorCorrector>(sde);
+    default:
+        return std::make_shared<EulerMethod>(sde);
+    }
+}
+
+// Build the configuration handed to every batch again, once the initial condition has been set
+static void refresh(mc_config& config)
+{
+    if (config.complete)
+    {
+        config.built = config.builder.build();
+    }
+}
+
+// Give the builder a fresh model and scheme; submitted jobs keep the components they were built with
+static void rebuild(mc_config& config)
+{
+    std::shared_ptr<SDE> sde = makeModel(config.model, config.parameters.data(), config.parameters.size());
+    sde->setBoundary(config.boundary);
+    config.builder.setSDE(sde).setFDM(makeScheme(config.scheme, sde)); // The scheme steps the new model, as in selectFDM()
+    refresh(config);
+}
+
+template <bool isUp, bool isIn>
+static std::shared_ptr<Payoff> makeBarrier(bool isCall, double K, double B)
+{
+    if (isCall)
+        return std::make_shared<BarrierOption<true, isUp, isIn>>(K, B);
+    else
+        return std::make_shared<BarrierOption<false, isUp, isIn>>(K, B);
+}
+
+static std::shared_ptr<Payoff> makePayoff(const mc_trade& trade)
+{
+    bool isCall = trade.is_call != 0;
+    switch (trade.payoff)
+    {
+    case MC_PAYOFF_EUROPEAN:
+        if (isCall)
+            return std::make_shared<EuropeanCall>(trade.strike);
+        else
+            return std::make_shared<EuropeanPut>(trade.strike);
+    case MC_PAYOFF_ASIAN:
+        return std::make_shared<AsianOption>(trade.strike, isCall);
+    case MC_PAYOFF_DIGITAL:
+        return std::make_shared<DigitalOption>(trade.strike, isCall);
+    case MC_PAYOFF_UP_AND_IN:
+        return makeBarrier<true, true>(isCall, trade.strike, trade.barrier);
+    case MC_PAYOFF_UP_AND_OUT:
+        return makeBarrier<true, false>(isCall, trade.strike, trade.barrier);
+    case MC_PAYOFF_DOWN_AND_IN:
+        return makeBarrier<false, true>(isCall, trade.strike, trade.barrier);
+    case MC_PAYOFF_DOWN_AND_OUT:
+        return makeBarrier<false, false>(isCall, trade.strike, trade.barrier);
+    default:
+        throw std::invalid_argument("Unknown payoff.");
+    }
+}
+
+// Payoff of trade, built on the configuration's first batch that contains it
+static std::shared_ptr<Payoff> lookupPayoff(const mc_config& config, const mc_trade& trade)
+{
+    bool barrier = trade.payoff >= MC_PAYOFF_UP_AND_IN;
+    TradeKey key(trade.payoff, trade.is_call != 0, trade.strike, barrier ? trade.barrier : 0.0); // The barrier only tells barrier trades apart
+    std::lock_guard<std::mutex> lock(config.payoffMutex);
+    auto found = config.payoffs.find(key);
+    if (found != config.payoffs.end())
+    {
+        return found->second;
+    }
+    std::shared_ptr<Payoff> payoff = makePayoff(trade);
+    if (config.payoffs.size() >= payoffCacheLimit)
+    {
+        config.payoffs.clear(); // Batches that still hold the old payoffs keep them alive
+    }
+    config.payoffs.emplace(key, payoff);
+    return payoff;
+}
+
+// Look up the payoff and path count of every trade into scratch
+static void prepare(const mc_config& config, const mc_trade* trades, std::size_t count, Scratch& scratch)
+{
+    if (!config.complete)
+    {
+        throw std::invalid_argument("The initial condition has not been set.");
+    }
+    if (!trades || count == 0)
+    {
+        throw std::invalid_argument("A batch needs at least one trade.");
+    }
+    scratch.payoffs.clear();
+    scratch.paths.clear();
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        if (trades[k].paths < 0 || trades[k].reserved != 0)
+        {
+            throw std::invalid_argument("Trade path counts must be non-negative and reserved fields zero.");
+        }
+        scratch.payoffs.push_back(lookupPayoff(config, trades[k]));
+        scratch.paths.push_back(trades[k].paths > 0 ? trades[k].paths : std::get<7>(config.built));
+    }
+}
+
+// Price the prepared trades on one set of paths into prices
+static void solve(const SimulationQueue::Config& config, const Scratch& scratch, double* prices)
+{
+    MCSolver solver(config); // The configuration's placeholder payoff passes the solver's validation
+    solver.solve(scratch.payoffs, scratch.paths, prices);
+}
+
+extern "C" {
+
+int32_t mc_version(void)
+{
+    return MCPRICER_VERSION;
+}
+
+const char* mc_last_error(void)
+{
+    return lastError.c_str();
+}
+
+mc_config* mc_config_create(void)
+{
+    mc_config* config = nullptr;
+    guarded([&]()
+    {
+        auto created = std::make_unique<mc_config>();
+        rebuild(*created);
+        created->builder.setRNG(std::make_shared<MersenneTwister>())
+            .setPayoff(std::make_shared<EuropeanCall>(0.0)); // Placeholder: every batch brings its own payoffs
+        config = created.release();
+    });
+    return config;
+}
+
+void mc_config_destroy(mc_config* config)
+{
+    delete config;
+}
+
+mc_status mc_config_set_model(mc_config* config, int32_t model, const double* parameters, size_t count)
+{
+    if (!config)
+    {
+        return fail(MC_INVALID_ARGUMENT, "Configuration handle is null.");
+    }
+    return guarded([&]()
+    {
+        makeModel(model, parameters, count); // Validate before changing anything
+        config->model = model;
+        config->parameters.assign(parameters, parameters + count);
+        rebuild(*config);
+    });
+}
+
+mc_status mc_config_set_scheme(mc_config* config, int32_t scheme)
+{
+    if (!config)
+    {
+        return fail(MC_INVALID_ARGUMENT, "Configuration handle is null.");
+    }
+    if (scheme < MC_SCHEME_EULER || scheme > MC_SCHEME_PREDICTOR_CORRECTOR)
+    {
+        return fail(MC_INVALID_ARGUMENT, "Unknown scheme.");
+    }
+    return guarded([&]()
+    {
+        config->scheme = static_cast<mc_scheme>(scheme);
+        rebuild(*config);
+    });
+}
+
+mc_status mc_config_set_boundary(mc_config* config, int32_t boundary)
+{
+    if (!config)
+    {
+        return fail(MC_INVALID_ARGUMENT, "Configuration handle is null.");
+    }
+    if (boundary < MC_BOUNDARY_ABSORB || boundary > MC_BOUNDARY_REJECT)
+    {
+        return fail(MC_INVALID_ARGUMENT, "Unknown boundary policy.");
+    }
+    return guarded([&]()
+    {
+        config->boundary = static_cast<Boundary>(boundary); // mc_boundary follows the order of Boundary
+        rebuild(*config); // A running job may still be applying the previous policy to its own model
+    });
+}
+
+mc_status mc_config_set_seed(mc_config* config, uint32_t seed)
+{
+    if (!config)
+    {
+        return fail(MC_INVALID_ARGUMENT, "Configuration handle is null.");
+    }
+    return guarded([&]()
+    {
+        config->builder.setRNG(std::make_shared<MersenneTwister>(seed));
+        refresh(*config);
+    });
+}
+
+mc_status mc_config_set_initial_condition(mc_config* config, double S0, double T, int32_t N, int32_t M)
+{
+    if (!config)
+    {
+        return fail(MC_INVALID_ARGUMENT, "Configuration handle is null.");
+    }
+    return guarded([&]()
+    {
+        config->builder.setInitialCondition(S0, T, N, M);
+        config->complete = true;
+        refresh(*config);
+    });
+}
+
+mc_status mc_price_batch(const mc_config* config, const mc_trade* trades, size_t count, double* prices)
+{
+    if (!config || !prices)
+    {
+        return fail(MC_INVALID_ARGUMENT, "Configuration handle or output array is null.");
+    }
+    return guarded([&]()
+    {
+        prepare(*config, trades, count, batchScratch);
+        solve(config->built, batchScratch, prices);
+    });
+}
+
+mc_job* mc_submit_batch(const mc_config* config, const mc_trade* trades, size_t count, double* prices,
+    mc_callback done, void* context)
+{
+    if (!config || !prices)
+    {
+        fail(MC_INVALID_ARGUMENT, "Configuration handle or output array is null.");
+        return nullptr;
+    }
+    mc_job* job = nullptr;
+    guarded([&]()
+    {
+        auto created = std::make_unique<mc_job>();
+        prepare(*config, trades, count, created->scratch); // Invalid trades are reported now, not by the job
+        created->config = config->built;
+        created->prices = prices;
+        created->done = done;
+        created->context = context;
+
+        mc_job* running = created.get();
+        running->finished = ThreadPool::instance().submit([running]()
+        {
+            mc_status status = guarded([running]() { solve(running->config, running->scratch, running->prices); });
+            running->error = lastError; // Published to other threads by the store below
+            running->status.store(status, std::memory_order_release);
+            if (running->done)
+            {
+                running->done(running->context, status);
+            }
+        });
+        job = created.release();
+    });
+    return job;
+}
+
+mc_status mc_job_poll(const mc_job* job)
+{
+    if (!job)
+    {
+        return fail(MC_INVALID_ARGUMENT, "Job handle is null.");
+    }
+    return job->status.load(std::memory_order_acquire);
+}
+
+mc_status mc_job_wait(mc_job* job)
+{
+    if (!job)
+    {
+        return fail(MC_INVALID_ARGUMENT, "Job handle is null.");
+    }
+    job->finished.wait();
+    return job->status.load(std::memory_order_acquire);
+}
+
+const char* mc_job_error(const mc_job* job)
+{
+    return job && job->status.load(std::memory_order_acquire) != MC_PENDING ? job->error.c_str() : "";
+}
+
+void mc_job_destroy(mc_job* job)
+{
+    if (job)
+    {
+        job->finished.wait(); // The task still refers to the job
+        delete job;
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+ * File: McPricer.h
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the C interface of the pricer, exported by the libmcpricer shared library for services that
+ * are not written in C++. A configuration handle plays the role of SimulationBuilder: it is created with defaults
+ * and changed through setters for the model, the scheme, the boundary policy, the seed and the initial condition.
+ * A batch of trades is priced in one call on one shared set of paths, the same fusion SimulationQueue applies:
+ * the trades are read where the caller keeps them and each price is written into the caller's output array, so
+ * nothing is marshalled or copied across the boundary. mc_submit_batch() runs the same batch on the thread pool
+ * and returns a job handle that can be polled, waited on or notified through a callback.
+ * Every function catches the exceptions of the engine and reports a status code; the message of the last error
+ * on the calling thread is available through mc_last_error(). The interface only uses fixed-width types, and
+ * MCPRICER_VERSION changes whenever a structure or a signature does.
+ */
+
+#ifndef MCPRICER_H
+#define MCPRICER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(MCPRICER_BUILD)
+#define MCPRICER_API __declspec(dllexport)
+#else
+#define MCPRICER_API __declspec(dllimport)
+#endif
+#else
+#define MCPRICER_API __attribute__((visibility("default")))
+#endif
+
+#define MCPRICER_VERSION 1 /* Version of the interface declared here */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum mc_status
+{
+    MC_OK = 0,               /* Success */
+    MC_INVALID_ARGUMENT = 1, /* A handle, parameter or trade was rejected */
+    MC_RUNTIME_ERROR = 2,    /* The simulation failed (for example, every path was rejected) */
+    MC_PENDING = 3           /* The job has not finished yet */
+} mc_status;
+
+typedef enum mc_model
+{
+    MC_MODEL_GBM = 0,            /* mu, sigma */
+    MC_MODEL_CEV = 1,            /* mu, sigma, gamma */
+    MC_MODEL_CIR = 2,            /* kappa, theta, sigma */
+    MC_MODEL_ROUGH_BERGOMI = 3,  /* r, xi, eta, H, rho (simulates its own paths) */
+    MC_MODEL_VARIANCE_GAMMA = 4, /* r, sigma, nu, theta (exact subordination) */
+    MC_MODEL_NIG = 5,            /* r, alpha, beta, delta (exact subordination) */
+    MC_MODEL_HESTON = 6,         /* r, kappa, theta, xi, rho, v0 (simulates its own paths) */
+    MC_MODEL_MERTON = 7          /* r, sigma, lambda, muJ, deltaJ (exact jumps) */
+} mc_model;
+
+typedef enum mc_scheme
+{
+    MC_SCHEME_EULER = 0,
+    MC_SCHEME_MILSTEIN = 1,
+    MC_SCHEME_PREDICTOR_CORRECTOR = 2
+} mc_scheme;
+
+typedef enum mc_boundary
+{
+    MC_BOUNDARY_ABSORB = 0,
+    MC_BOUNDARY_REFLECT = 1,
+    MC_BOUNDARY_TRUNCATE = 2,
+    MC_BOUNDARY_REJECT = 3
+} mc_boundary;
+
+typedef enum mc_payoff
+{
+    MC_PAYOFF_EUROPEAN = 0,
+    MC_PAYOFF_ASIAN = 1,         /* Geometric average over the full grid */
+    MC_PAYOFF_DIGITAL = 2,       /* Cash-or-nothing, pays 1 */
+    MC_PAYOFF_UP_AND_IN = 3,     /* Barrier options, monitored at every step */
+    MC_PAYOFF_UP_AND_OUT = 4,
+    MC_PAYOFF_DOWN_AND_IN = 5,
+    MC_PAYOFF_DOWN_AND_OUT = 6
+} mc_payoff;
+
+typedef struct mc_trade
+{
+    double strike;   /* Strike price */
+    double barrier;  /* Barrier level (barrier payoffs only) */
+    int32_t payoff;  /* One of mc_payoff */
+    int32_t is_call; /* Non-zero for a call, zero for a put */
+    int32_t paths;   /* Paths to average over; 0 uses the configuration's count */
+    int32_t reserved; /* Must be zero */
+} mc_trade;
+
+typedef struct mc_config mc_config; /* Simulation configuration, the counterpart of SimulationBuilder */
+typedef struct mc_job mc_job; /* Batch submitted for asynchronous pricing */
+
+typedef void (*mc_callback)(void* context, mc_status status); /* Called on a pool thread when a job finishes */
+
+MCPRICER_API int32_t mc_version(void); /* MCPRICER_VERSION of the loaded library */
+MCPRICER_API const char* mc_last_error(void); /* Message of the last failure on the calling thread ("" if none) */
+
+/* Configuration: GBM(0.05, 0.2), Euler, absorbing boundary and a random seed until changed; the initial condition must be set */
+MCPRICER_API mc_config* mc_config_create(void); /* NULL on failure */
+MCPRICER_API void mc_config_destroy(mc_config* config); /* Jobs already submitted keep their own copy */
+MCPRICER_API mc_status mc_config_set_model(mc_config* config, int32_t model, const double* parameters, size_t count);
+MCPRICER_API mc_status mc_config_set_scheme(mc_config* config, int32_t scheme);
+MCPRICER_API mc_status mc_config_set_boundary(mc_config* config, int32_t boundary);
+MCPRICER_API mc_status mc_config_set_seed(mc_config* config, uint32_t seed); /* Every batch draws new paths; set the seed again to repeat one */
+MCPRICER_API mc_status mc_config_set_initial_condition(mc_config* config, double S0, double T, int32_t N, int32_t M);
+
+/* Price count trades on one set of paths and write prices[0..count); the arrays stay owned by the caller */
+MCPRICER_API mc_status mc_price_batch(const mc_config* config, const mc_trade* trades, size_t count, double* prices);
+
+/* Queue the same batch on the thread pool. The trades are read before the call returns; prices must stay valid until
+   the job has finished. done may be NULL and must not wait on or destroy the job. Returns NULL (and nothing is
+   queued) if the configuration or a trade is invalid. */
+MCPRICER_API mc_job* mc_submit_batch(const mc_config* config, const mc_trade* trades, size_t count, double* prices,
+    mc_callback done, void* context);
+MCPRICER_API mc_status mc_job_poll(const mc_job* job); /* MC_PENDING until the job has finished, then its status */
+MCPRICER_API mc_status mc_job_wait(mc_job* job); /* Block until the job has finished and return its status */
+MCPRICER_API const char* mc_job_error(const mc_job* job); /* Message of a failed job ("" otherwise) */
+MCPRICER_API void mc_job_destroy(mc_job* job); /* Waits for the job if it is still running */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MCPRICER_H */
\ No newline at end of file
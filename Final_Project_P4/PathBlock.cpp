@@ -0,0 +1,121 @@
+/*
+ * File: PathBlock.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the PathBlock class. The block owns a single time-major buffer that is allocated once and
+ * reused for every batch of paths, so that producing a new block never touches the heap. The last block of a
+ * simulation is usually only partially filled, which is handled by resize().
+ */
+
+#include "PathBlock.hpp"
+#include <algorithm>
+
+PathBlock::PathBlock(std::size_t capacity, const std::vector<double>& times)
+    : capacity(capacity), paths(capacity), steps(times.empty() ? 0 : times.size() - 1), grid(times), values(capacity * times.size()), flags(capacity, 0),
+      logs(capacity, 0.0), logged(false)
+{
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("PathBlock capacity must be positive.");
+    }
+    if (times.size() < 2)
+    {
+        throw std::invalid_argument("PathBlock needs at least an initial and a final time.");
+    }
+}
+
+void PathBlock::resize(std::size_t n)
+{
+    if (n > capacity)
+    {
+        throw std::invalid_argument("PathBlock size exceeds its capacity.");
+    }
+    paths = n; // Rows keep their stride; only the first n entries of each row are active
+}
+
+std::size_t PathBlock::size() const
+{
+    return paths;
+}
+
+std::size_t PathBlock::numSteps() const
+{
+    return steps;
+}
+
+const std::vector<double>& PathBlock::times() const
+{
+    return grid;
+}
+
+std::size_t PathBlock::rowAt(double t) const
+{
+    double tolerance = 1e-9 * grid.back(); // Absorb rounding in j * dt
+    auto it = std::lower_bound(grid.begin(), grid.end(), t - tolerance);
+    if (it == grid.end())
+    {
+        throw std::out_of_range("Observation date is after the last simulated time.");
+    }
+    return static_cast<std::size_t>(it - grid.begin());
+}
+
+double* PathBlock::row(std::size_t j)
+{
+    return values.data() + j * capacity; // Rows are strided by capacity so resize() never moves data
+}
+
+const double* PathBlock::row(std::size_t j) const
+{
+    return values.data() + j * capacity;
+}
+
+const double* PathBlock::terminal() const
+{
+    return row(steps); // The last row holds the prices at maturity
+}
+
+double PathBlock::at(std::size_t j, std::size_t p) const
+{
+    return values[j * capacity + p];
+}
+
+void PathBlock::copyPath(std::size_t p, std::vector<double>& path) const
+{
+    path.resize(steps + 1);
+    for (std::size_t j = 0; j <= steps; ++j)
+    {
+        path[j] = values[j * capacity + p]; // Gather path p across the time-major rows
+    }
+}
+
+std::uint8_t* PathBlock::rejected()
+{
+    return flags.data();
+}
+
+const std::uint8_t* PathBlock::rejected() const
+{
+    return flags.data();
+}
+
+double* PathBlock::logSums()
+{
+    return logs.data();
+}
+
+const double* PathBlock::logSums() const
+{
+    return logs.data();
+}
+
+bool PathBlock::hasLogSums() const
+{
+    return logged;
+}
+
+void PathBlock::setLogSums(bool recorded)
+{
+    logged = recorded;
+}
\ No newline at end of file
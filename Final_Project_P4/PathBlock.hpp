@@ -0,0 +1,63 @@
+/*
+ * File: PathBlock.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the PathBlock class, a contiguous block of simulated price paths that is produced and consumed
+ * as a unit by the Monte Carlo engine. Values are stored time-major (all paths at step 0, then all paths at step 1, ...)
+ * so that stepping the whole block forward in time and evaluating terminal payoffs touch contiguous memory.
+ * Path-dependent consumers can still extract a single path through copyPath().
+ * The block also carries its time grid, which is either the uniform N-step grid or a sparse grid of observation
+ * dates; payoffs that observe specific dates locate their rows with rowAt().
+ * A flag per path marks paths rejected by the Reject boundary policy, which consumers leave out of their estimates.
+ * Producers that step log S anyway may also record, per path, the sum of log S over every row; geometric averages
+ * then come out of the block without a single logarithm.
+ */
+
+#ifndef PATHBLOCK_HPP
+#define PATHBLOCK_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+class PathBlock
+{
+private:
+    std::size_t capacity; // Maximum number of paths the block can hold
+    std::size_t paths;    // Number of paths currently held in the block
+    std::size_t steps;    // Number of time steps per path (each path has steps + 1 points)
+    std::vector<double> grid; // Time of each row (grid[0] = 0, grid[steps] = maturity)
+    std::vector<double> values; // Time-major storage: values[j * capacity + p] is path p at step j
+    std::vector<std::uint8_t> flags; // flags[p] is 1 if path p was rejected by the boundary policy
+    std::vector<double> logs; // logs[p] is the sum of log S over every row of path p, if the producer recorded it
+    bool logged; // True if logs holds the sums for the current contents of the block
+
+public:
+    PathBlock(std::size_t capacity, const std::vector<double>& times); // Constructor, one row per entry of times
+
+    void resize(std::size_t n); // Set the number of active paths (n <= capacity)
+    std::size_t size() const; // Number of active paths
+    std::size_t numSteps() const; // Number of time steps per path
+    const std::vector<double>& times() const; // Time of each row
+    std::size_t rowAt(double t) const; // First row whose time is not before t
+
+    double* row(std::size_t j); // Pointer to the prices of all paths at step j
+    const double* row(std::size_t j) const; // Pointer to the prices of all paths at step j
+    const double* terminal() const; // Pointer to the prices of all paths at maturity
+
+    double at(std::size_t j, std::size_t p) const; // Price of path p at step j
+    void copyPath(std::size_t p, std::vector<double>& path) const; // Copy path p into a contiguous vector
+
+    std::uint8_t* rejected(); // Rejection flag of every path (0 or 1)
+    const std::uint8_t* rejected() const; // Rejection flag of every path (0 or 1)
+
+    double* logSums(); // Sum of log S over every row of each path
+    const double* logSums() const; // Sum of log S over every row of each path
+    bool hasLogSums() const; // True if the producer filled logSums() for the current paths
+    void setLogSums(bool recorded); // Mark logSums() as filled (by the producer) or stale (before refilling the block)
+};
+
+#endif // PATHBLOCK_HPP
\ No newline at end of file
@@ -0,0 +1,595 @@
+/*
+ * File: PathCache.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the PathCache class on shm_open and mmap. The index segment starts with a header (an
+ * initialisation flag, the layout version, the mutex, the capacity, the bytes in use and two counters) followed by
+ * the entry table. Entries are looked up by a 64-bit FNV-1a hash of the key; the data object repeats the full key,
+ * which is compared after mapping, so a hash collision is a miss rather than wrong paths. An entry being written is
+ * marked with its writer's process id so that readers skip it and eviction leaves it alone while the writer lives;
+ * once kill(pid, 0) reports the writer gone, the next publish() or clear() reclaims the slot and its bytes. Readers
+ * are recorded the same way, as a process id and a mapping count per reader, and an eviction that finds no free
+ * entry first drops the mappings of readers that no longer exist. The mutex is only held to update the table, never
+ * while chunk data is copied. The data object is reserved with posix_fallocate before it is mapped for writing, so
+ * a full /dev/shm makes publish() fail instead of faulting on the first write.
+ */
+
+#include "PathCache.hpp"
+#include <cstring>
+#include <new>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <chrono>
+#include <thread>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr std::uint32_t initialised = 0x4D435043; // Written last by the creator of the index
+    constexpr std::uint32_t layoutVersion = 3;
+    constexpr std::size_t maxReaders = 8; // Processes that may have one entry mapped at the same time
+
+    enum : std::uint32_t
+    {
+        Empty = 0, // Free slot
+        Writing = 1, // Reserved by a process that is still writing the data
+        Ready = 2 // Readable
+    };
+
+    struct Entry
+    {
+        std::uint64_t hash; // FNV-1a hash of the key
+        std::uint64_t bytes; // Size of the data object
+        std::uint64_t lastUse; // Clock value of the last lookup or store
+        std::uint64_t generation; // Distinguishes successive entries of the same slot (part of the data object's name)
+        std::int64_t references; // Mappings currently held by readers (sum of readerCounts)
+        std::uint32_t state; // Empty, Writing or Ready
+        std::int32_t writer; // Process id of the writer while Writing
+        std::int32_t readers[maxReaders]; // Process ids of the readers holding mappings (0 for a free record)
+        std::uint32_t readerCounts[maxReaders]; // Mappings held by each of them
+    };
+
+    struct Index
+    {
+        std::uint32_t ready; // initialised once the header is usable (accessed atomically)
+        std::uint32_t version; // layoutVersion
+        std::uint32_t slots; // Entries in the table
+        std::uint32_t padding;
+        pthread_mutex_t mutex; // Process-shared, robust
+        std::uint64_t capacity; // Bytes of data allowed
+        std::uint64_t used; // Bytes of data of non-empty entries
+        std::uint64_t clock; // Logical time for least-recently-used eviction
+        std::uint64_t generations; // Last generation handed out
+    };
+
+    struct DataHeader
+    {
+        std::uint64_t keyBytes; // Length of the key that follows, padded to 8 bytes in the object
+        std::uint64_t rows;
+        std::uint64_t paths;
+        std::uint64_t fired;
+        std::uint64_t dropped;
+    };
+
+    Entry* entries(void* index)
+    {
+        return reinterpret_cast<Entry*>(static_cast<Index*>(index) + 1); // The table follows the header
+    }
+
+    std::uint64_t fnv1a(const std::string& key)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : key)
+        {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::size_t padded(std::size_t bytes)
+    {
+        return (bytes + 7) & ~std::size_t(7);
+    }
+
+    bool exists(std::int32_t pid)
+    {
+        return kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH; // EPERM: alive, only owned by someone else
+    }
+
+    bool abandoned(const Entry& entry) // Reserved for writing by a process that no longer exists
+    {
+        return entry.state == Writing && !exists(entry.writer);
+    }
+
+    bool addReader(Entry& entry, std::int32_t pid) // Record one more mapping of pid; false if every record is taken
+    {
+        std::size_t record = maxReaders;
+        for (std::size_t r = 0; r < maxReaders; ++r)
+        {
+            if (entry.readers[r] == pid)
+            {
+                record = r;
+                break;
+            }
+            if (entry.readers[r] == 0 && record == maxReaders)
+            {
+                record = r;
+            }
+        }
+        if (record == maxReaders)
+        {
+            return false;
+        }
+        entry.readers[record] = pid;
+        ++entry.readerCounts[record];
+        ++entry.references;
+        return true;
+    }
+
+    void dropReader(Entry& entry, std::int32_t pid) // Forget one mapping of pid
+    {
+        for (std::size_t r = 0; r < maxReaders; ++r)
+        {
+            if (entry.readers[r] == pid && entry.readerCounts[r] > 0)
+            {
+                --entry.references;
+                if (--entry.readerCounts[r] == 0)
+                {
+                    entry.readers[r] = 0;
+                }
+                return;
+            }
+        }
+    }
+
+    void dropDeadReaders(Entry& entry) // Forget the mappings of readers that no longer exist
+    {
+        for (std::size_t r = 0; r < maxReaders; ++r)
+        {
+            if (entry.readers[r] != 0 && !exists(entry.readers[r]))
+            {
+                entry.references -= entry.readerCounts[r];
+                entry.readers[r] = 0;
+                entry.readerCounts[r] = 0;
+            }
+        }
+    }
+
+    class Lock // Holds the index mutex, recovering it if its owner died
+    {
+    private:
+        pthread_mutex_t* mutex;
+        bool held; // Whether the mutex was acquired
+
+        static bool acquire(pthread_mutex_t* mutex) noexcept
+        {
+            int result = pthread_mutex_lock(mutex);
+            if (result == EOWNERDEAD)
+            {
+                pthread_mutex_consistent(mutex); // Every update leaves the table usable, so carry on
+                return true;
+            }
+            return result == 0;
+        }
+
+    public:
+        explicit Lock(pthread_mutex_t* mutex) : mutex(mutex), held(acquire(mutex))
+        {
+            if (!held)
+            {
+                throw std::runtime_error("Cannot lock the path cache index.");
+            }
+        }
+        Lock(pthread_mutex_t* mutex, std::nothrow_t) noexcept : mutex(mutex), held(acquire(mutex)) // Check owns() instead of catching
+        {
+        }
+        ~Lock()
+        {
+            if (held)
+            {
+                pthread_mutex_unlock(mutex);
+            }
+        }
+        bool owns() const noexcept
+        {
+            return held;
+        }
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+    };
+}
+
+PathCache::PathCache(const std::string& name, std::size_t capacity, std::uint32_t slots)
+    : name(name), index(nullptr), indexBytes(sizeof(Index) + sizeof(Entry) * slots)
+{
+    if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos)
+    {
+        throw std::invalid_argument("Path cache names must start with '/' and contain no other '/'.");
+    }
+    if (capacity == 0 || slots == 0)
+    {
+        throw std::invalid_argument("Path cache capacity and slots must be positive.");
+    }
+
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    bool creator = fd >= 0;
+    if (creator)
+    {
+        if (ftruncate(fd, static_cast<off_t>(indexBytes)) != 0)
+        {
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error("Cannot size the path cache index.");
+        }
+    }
+    else
+    {
+        if (errno != EEXIST || (fd = shm_open(name.c_str(), O_RDWR, 0600)) < 0)
+        {
+            throw std::runtime_error("Cannot open the path cache index " + name + ".");
+        }
+        struct stat status;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (fstat(fd, &status) == 0 && status.st_size == 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1)); // The creator has not sized it yet
+        }
+        indexBytes = static_cast<std::size_t>(status.st_size); // The creator's table size wins
+        if (indexBytes < sizeof(Index))
+        {
+            close(fd);
+            throw std::runtime_error("The path cache index " + name + " was never initialised.");
+        }
+    }
+
+    index = mmap(nullptr, indexBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (index == MAP_FAILED)
+    {
+        index = nullptr;
+        throw std::runtime_error("Cannot map the path cache index.");
+    }
+
+    Index* header = static_cast<Index*>(index);
+    std::atomic_ref<std::uint32_t> ready(header->ready);
+    if (creator)
+    {
+        pthread_mutexattr_t attributes;
+        pthread_mutexattr_init(&attributes);
+        pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&header->mutex, &attributes);
+        pthread_mutexattr_destroy(&attributes);
+        header->version = layoutVersion;
+        header->slots = slots;
+        header->capacity = capacity; // The rest of the segment is already zero: every entry is Empty
+        ready.store(initialised, std::memory_order_release);
+        return;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (ready.load(std::memory_order_acquire) != initialised)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            munmap(index, indexBytes);
+            index = nullptr;
+            throw std::runtime_error("The path cache index " + name + " was never initialised.");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (header->version != layoutVersion || indexBytes < sizeof(Index) + sizeof(Entry) * header->slots)
+    {
+        munmap(index, indexBytes);
+        index = nullptr;
+        throw std::runtime_error("The path cache index " + name + " has an incompatible layout.");
+    }
+}
+
+PathCache::~PathCache()
+{
+    if (index)
+    {
+        munmap(index, indexBytes);
+    }
+}
+
+std::string PathCache::dataName(std::uint32_t slot, std::uint64_t generation) const
+{
+    return name + "." + std::to_string(slot) + "." + std::to_string(generation);
+}
+
+void PathCache::evict(std::uint32_t slot)
+{
+    Index* header = static_cast<Index*>(index);
+    Entry& entry = entries(index)[slot];
+    shm_unlink(dataName(slot, entry.generation).c_str()); // Also removes what a dead writer left half written
+    header->used -= entry.bytes;
+    entry.state = Empty;
+}
+
+std::shared_ptr<const CachedChunk> PathCache::find(const std::string& key)
+{
+    Index* header = static_cast<Index*>(index);
+    Entry* table = entries(index);
+    std::uint64_t hash = fnv1a(key);
+    std::uint32_t slot = header->slots;
+    std::uint64_t generation = 0, bytes = 0;
+    {
+        Lock lock(&header->mutex);
+        for (std::uint32_t s = 0; s < header->slots; ++s)
+        {
+            if (table[s].state == Ready && table[s].hash == hash)
+            {
+                if (addReader(table[s], static_cast<std::int32_t>(getpid()))) // Keeps the entry from eviction while it is mapped
+                {
+                    slot = s;
+                    generation = table[s].generation;
+                    bytes = table[s].bytes;
+                    table[s].lastUse = ++header->clock;
+                }
+                break; // With every reader record taken, this lookup is a miss
+            }
+        }
+    }
+    if (slot == header->slots)
+    {
+        ++missCount;
+        return nullptr;
+    }
+
+    void* base = MAP_FAILED;
+    int fd = shm_open(dataName(slot, generation).c_str(), O_RDONLY, 0);
+    if (fd >= 0)
+    {
+        base = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+    }
+    const DataHeader* data = base == MAP_FAILED ? nullptr : static_cast<const DataHeader*>(base);
+    const char* stored = data ? reinterpret_cast<const char*>(data + 1) : nullptr;
+    if (!data || data->keyBytes != key.size() || std::memcmp(stored, key.data(), key.size()) != 0)
+    {
+        if (base != MAP_FAILED)
+        {
+            munmap(base, bytes);
+        }
+        release(slot, generation); // Cleared meanwhile, or a hash collision
+        ++missCount;
+        return nullptr;
+    }
+
+    const double* values = reinterpret_cast<const double*>(stored + padded(key.size()));
+    CachedChunk* chunk = new CachedChunk{ values, reinterpret_cast<const std::uint8_t*>(values + data->rows * data->paths),
+        data->rows, data->paths, data->fired, data->dropped };
+    ++hitCount;
+    std::shared_ptr<PathCache> self = shared_from_this();
+    return std::shared_ptr<const CachedChunk>(chunk, [self, base, bytes, slot, generation](const CachedChunk* chunk) noexcept
+    {
+        munmap(base, bytes);
+        self->release(slot, generation);
+        delete chunk;
+    });
+}
+
+void PathCache::release(std::uint32_t slot, std::uint64_t generation) noexcept
+{
+    Index* header = static_cast<Index*>(index);
+    Entry& entry = entries(index)[slot];
+    Lock lock(&header->mutex, std::nothrow);
+    if (!lock.owns())
+    {
+        return; // Runs in a deleter, so it must not throw; the leftover reference only keeps the entry from eviction
+    }
+    if (entry.state != Empty && entry.generation == generation)
+    {
+        dropReader(entry, static_cast<std::int32_t>(getpid())); // A forked child holds no record of its own and drops nothing
+    }
+}
+
+bool PathCache::publish(const std::string& key, const double* values, const std::uint8_t* rejected, std::size_t rows, std::size_t paths,
+    std::uint64_t fired, std::uint64_t dropped)
+{
+    Index* header = static_cast<Index*>(index);
+    Entry* table = entries(index);
+    std::uint64_t hash = fnv1a(key);
+    std::size_t offset = sizeof(DataHeader) + padded(key.size()); // Start of the prices
+    std::size_t bytes = offset + rows * paths * sizeof(double) + paths;
+    if (bytes > header->capacity)
+    {
+        return false;
+    }
+
+    std::uint32_t slot = header->slots;
+    std::uint64_t generation;
+    {
+        Lock lock(&header->mutex);
+        std::uint32_t free = header->slots;
+        for (std::uint32_t s = 0; s < header->slots; ++s)
+        {
+            if (abandoned(table[s]))
+            {
+                evict(s);
+            }
+            if (table[s].state != Empty && table[s].hash == hash)
+            {
+                return false; // Stored, or being stored, by another process
+            }
+            if (table[s].state == Empty && free == header->slots)
+            {
+                free = s;
+            }
+        }
+        for (std::uint32_t s = 0; (free == header->slots || header->used + bytes > header->capacity) && s < header->slots; ++s)
+        {
+            if (table[s].state == Ready && table[s].references > 0)
+            {
+                dropDeadReaders(table[s]); // Mappings of crashed readers must not pin entries forever
+            }
+        }
+        while (free == header->slots || header->used + bytes > header->capacity)
+        {
+            std::uint32_t victim = header->slots; // Least recently used entry that nobody has mapped
+            for (std::uint32_t s = 0; s < header->slots; ++s)
+            {
+                if (table[s].state == Ready && table[s].references == 0
+                    && (victim == header->slots || table[s].lastUse < table[victim].lastUse))
+                {
+                    victim = s;
+                }
+            }
+            if (victim == header->slots)
+            {
+                return false; // Everything left is in use: do not cache this chunk
+            }
+            evict(victim);
+            free = victim;
+        }
+        slot = free;
+        generation = ++header->generations;
+        table[slot] = Entry{ hash, bytes, ++header->clock, generation, 0, Writing, static_cast<std::int32_t>(getpid()), {}, {} };
+        header->used += bytes;
+    }
+
+    std::string object = dataName(slot, generation);
+    bool written = false;
+    int fd = shm_open(object.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0)
+    {
+        void* base = posix_fallocate(fd, 0, static_cast<off_t>(bytes)) == 0
+            ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (base != MAP_FAILED)
+        {
+            char* out = static_cast<char*>(base);
+            DataHeader data{ key.size(), rows, paths, fired, dropped };
+            std::memcpy(out, &data, sizeof(data));
+            std::memcpy(out + sizeof(data), key.data(), key.size());
+            std::memcpy(out + offset, values, rows * paths * sizeof(double));
+            std::memcpy(out + offset + rows * paths * sizeof(double), rejected, paths);
+            munmap(base, bytes);
+            written = true;
+        }
+        else
+        {
+            shm_unlink(object.c_str());
+        }
+    }
+
+    Lock lock(&header->mutex);
+    if (table[slot].generation == generation && table[slot].state == Writing)
+    {
+        if (written)
+        {
+            table[slot].state = Ready;
+        }
+        else
+        {
+            table[slot].state = Empty; // Give the space back
+            header->used -= bytes;
+        }
+    }
+    return written;
+}
+
+void PathCache::clear()
+{
+    Index* header = static_cast<Index*>(index);
+    Entry* table = entries(index);
+    Lock lock(&header->mutex);
+    for (std::uint32_t s = 0; s < header->slots; ++s)
+    {
+        if (table[s].state == Ready || abandoned(table[s])) // Entries still being written are left to their writers
+        {
+            evict(s);
+        }
+    }
+}
+
+void PathCache::remove(const std::string& name)
+{
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+    {
+        return; // No such cache
+    }
+    bool usable = false; // Whether the index was initialised with this layout, so its data objects can be found
+    struct stat status;
+    if (fstat(fd, &status) == 0 && static_cast<std::size_t>(status.st_size) >= sizeof(Index))
+    {
+        void* base = mmap(nullptr, sizeof(Index), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base != MAP_FAILED)
+        {
+            Index* header = static_cast<Index*>(base);
+            usable = std::atomic_ref<std::uint32_t>(header->ready).load(std::memory_order_acquire) == initialised
+                && header->version == layoutVersion;
+            munmap(base, sizeof(Index));
+        }
+    }
+    close(fd);
+    if (usable)
+    {
+        PathCache(name).clear();
+    }
+    shm_unlink(name.c_str()); // An index whose creator died before initialising it holds no entries
+}
+#else
+PathCache::PathCache(const std::string& name, std::size_t capacity, std::uint32_t slots)
+    : name(name), index(nullptr), indexBytes(0)
+{
+    throw std::runtime_error("The path cache needs POSIX shared memory.");
+}
+
+PathCache::~PathCache()
+{
+}
+
+std::string PathCache::dataName(std::uint32_t slot, std::uint64_t generation) const
+{
+    return name;
+}
+
+std::shared_ptr<const CachedChunk> PathCache::find(const std::string& key)
+{
+    return nullptr;
+}
+
+void PathCache::evict(std::uint32_t slot)
+{
+}
+
+void PathCache::release(std::uint32_t slot, std::uint64_t generation) noexcept
+{
+}
+
+bool PathCache::publish(const std::string& key, const double* values, const std::uint8_t* rejected, std::size_t rows, std::size_t paths,
+    std::uint64_t fired, std::uint64_t dropped)
+{
+    return false;
+}
+
+void PathCache::clear()
+{
+}
+
+void PathCache::remove(const std::string& name)
+{
+}
+#endif
+
+std::uint64_t PathCache::hits() const
+{
+    return hitCount.load();
+}
+
+std::uint64_t PathCache::misses() const
+{
+    return missCount.load();
+}
\ No newline at end of file
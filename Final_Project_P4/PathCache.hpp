@@ -0,0 +1,81 @@
+/*
+ * File: PathCache.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the PathCache class, a host-wide cache of simulated path chunks shared between processes through
+ * named POSIX shared memory. Several pricing processes that simulate the same model on the same grid from the same
+ * seed draw identical paths; with a shared cache only the first one simulates them and the others map the stored
+ * chunk read-only and copy its rows into their path blocks.
+ * An entry holds one chunk: every path drawn from one freshly seeded RNG stream, stored time-major, with the paths
+ * rejected by the boundary policy and the policy's counters. Its key is an exact description of everything the
+ * paths depend on (model and scheme with their parameters, boundary policy, grid, S0, path and block counts, the
+ * stream's seed and the instruction set of the step kernels); PathGenerator builds it.
+ * The index lives in one segment named after the cache: a process-shared robust mutex, a logical clock and a fixed
+ * table of entries with their key hash, size, reference count and last use. Each entry's data is a separate shared
+ * memory object, so an entry can be evicted (unlinked) while another process still has it mapped: the mapping stays
+ * valid until that process releases it. Eviction is least recently used among unreferenced entries, whenever a new
+ * chunk would exceed the capacity or find no free slot; a chunk that does not fit is simply not cached.
+ * The first process to open a name creates the segment with its capacity; later processes use the existing one.
+ * Every entry records which processes have it mapped (a few at a time; a further process gets a miss), so the
+ * mappings of a reader that crashed are dropped by the next eviction, and an entry whose writer crashed is
+ * reclaimed by the next publish() or clear().
+ * Only POSIX systems are supported; on Windows the constructor throws.
+ */
+
+#ifndef PATHCACHE_HPP
+#define PATHCACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+struct CachedChunk // Read-only view of one cached chunk, valid while the shared pointer is held
+{
+    const double* values; // rows x paths prices, time-major: row j starts at values + j * paths
+    const std::uint8_t* rejected; // One flag per path
+    std::size_t rows; // Grid points per path
+    std::size_t paths; // Paths in the chunk
+    std::uint64_t fired; // Boundary policy counters of the simulation that produced the chunk
+    std::uint64_t dropped;
+};
+
+class PathCache : public std::enable_shared_from_this<PathCache>
+{
+private:
+    std::string name; // Name of the index segment, starting with '/'
+    void* index; // Mapped index segment
+    std::size_t indexBytes; // Size of the mapping
+    std::atomic<std::uint64_t> hitCount{ 0 }; // Lookups of this process served from the cache
+    std::atomic<std::uint64_t> missCount{ 0 }; // Lookups of this process that found nothing
+
+    std::string dataName(std::uint32_t slot, std::uint64_t generation) const; // Name of an entry's data object
+    void release(std::uint32_t slot, std::uint64_t generation) noexcept; // Drop one reference to an entry (never throws)
+    void evict(std::uint32_t slot); // Unlink an entry's data and free its slot and bytes (index mutex held)
+
+public:
+    static constexpr std::size_t defaultCapacity = std::size_t(1) << 30; // Bytes of chunk data kept by default
+    static constexpr std::uint32_t defaultSlots = 256; // Entries in the index by default
+
+    // Open the cache called name ("/name" for shm_open), creating it with the given capacity and slots if it does not
+    // exist yet. Create it with std::make_shared: cached chunks keep the cache alive.
+    PathCache(const std::string& name, std::size_t capacity = defaultCapacity, std::uint32_t slots = defaultSlots);
+    ~PathCache(); // Unmaps the index (the shared segment stays)
+    PathCache(const PathCache&) = delete;
+    PathCache& operator=(const PathCache&) = delete;
+
+    std::shared_ptr<const CachedChunk> find(const std::string& key); // Map the chunk stored under key (null if absent)
+    // Store a chunk under key unless it is already there or cannot be made to fit; returns true if it was stored
+    bool publish(const std::string& key, const double* values, const std::uint8_t* rejected, std::size_t rows, std::size_t paths,
+        std::uint64_t fired, std::uint64_t dropped);
+    void clear(); // Evict every entry (processes keep the chunks they have mapped)
+    std::uint64_t hits() const; // Lookups of this process served from the cache
+    std::uint64_t misses() const; // Lookups of this process that found nothing
+    static void remove(const std::string& name); // Clear and unlink the cache called name, if it exists
+};
+
+#endif // PATHCACHE_HPP
\ No newline at end of file
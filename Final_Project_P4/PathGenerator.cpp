@@ -0,0 +1,242 @@
+/*
+ * File: PathGenerator.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the PathGenerator class. The blocks() coroutine fills a PathBlock step by step: for every
+ * time step it draws one normal per path in a single RNG call, scales it to a Wiener increment and advances the
+ * whole row with one FDM call. Once the block reaches maturity it is yielded to the consumer, and the coroutine
+ * is suspended until the next block is requested. In exact mode the SDE samples the interval between two
+ * consecutive dates itself, drawing what its transition law needs from the RNG (one normal per path for GBM,
+ * subordinator samples for the Levy models) instead of the normals being scaled into Wiener increments for the FDM.
+ * After every step the model's boundary policy is applied to the new row, and its counters are updated once per block.
+ * A cached chunk replays the boundary counters of the simulation that stored it, once, so the counters read the
+ * same whether the paths were simulated or copied.
+ * At fixed width the extra lanes of a partial block are the paths a larger request would have produced there; they
+ * are stepped and bounded like the others but left out of the boundary counters.
+ */
+
+#include "PathGenerator.hpp"
+#include "Dispatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+PathGenerator::PathGenerator(std::shared_ptr<FDM> fdm, std::shared_ptr<RNG> rng, double S0, double T, int N, int M,
+    std::size_t blockSize)
+    : fdm(fdm), rng(rng), S0(S0), M(M), blockSize(blockSize), fixedWidth(false)
+{
+    if (!fdm || !rng)
+    {
+        throw std::invalid_argument("FDM or RNG pointer is null in PathGenerator constructor.");
+    }
+    if (S0 <= 0 || T <= 0 || N <= 0 || M <= 0 || blockSize == 0)
+    {
+        throw std::invalid_argument("Initial conditions (S0, T, N, M) and block size must be positive.");
+    }
+    double dt = T / N; // Time step size
+    grid.resize(N + 1);
+    for (int j = 0; j <= N; ++j)
+    {
+        grid[j] = j * dt;
+    }
+}
+
+PathGenerator::PathGenerator(std::shared_ptr<SDE> sde, std::shared_ptr<RNG> rng, double S0, const std::vector<double>& dates, int M,
+    std::size_t blockSize)
+    : model(sde), rng(rng), S0(S0), grid(1, 0.0), M(M), blockSize(blockSize), fixedWidth(false)
+{
+    if (!sde || !rng)
+    {
+        throw std::invalid_argument("SDE or RNG pointer is null in PathGenerator constructor.");
+    }
+    if (!sde->hasExactTransition())
+    {
+        throw std::invalid_argument("SDE has no exact transition law; simulate it on a full grid with an FDM scheme.");
+    }
+    if (S0 <= 0 || M <= 0 || blockSize == 0 || dates.empty())
+    {
+        throw std::invalid_argument("Initial price, path count, block size and observation dates must be positive.");
+    }
+    for (double t : dates)
+    {
+        if (t <= grid.back())
+        {
+            throw std::invalid_argument("Observation dates must be positive and strictly increasing.");
+        }
+        grid.push_back(t);
+    }
+}
+
+PathGenerator::PathGenerator(std::shared_ptr<SDE> sde, std::shared_ptr<RNG> rng, double S0, double T, int N, int M,
+    std::size_t blockSize)
+    : model(sde), rng(rng), S0(S0), M(M), blockSize(blockSize), fixedWidth(false)
+{
+    if (!sde || !rng)
+    {
+        throw std::invalid_argument("SDE or RNG pointer is null in PathGenerator constructor.");
+    }
+    if (!sde->simulatesPaths())
+    {
+        throw std::invalid_argument("SDE does not simulate paths itself; step it with an FDM scheme.");
+    }
+    if (S0 <= 0 || T <= 0 || N <= 0 || M <= 0 || blockSize == 0)
+    {
+        throw std::invalid_argument("Initial conditions (S0, T, N, M) and block size must be positive.");
+    }
+    grid.resize(N + 1);
+    for (int j = 0; j <= N; ++j)
+    {
+        grid[j] = T * j / N;
+    }
+}
+
+void PathGenerator::useCache(std::shared_ptr<PathCache> cache)
+{
+    this->cache = cache;
+}
+
+void PathGenerator::setFixedWidth(bool fixed)
+{
+    fixedWidth = fixed;
+}
+
+std::string PathGenerator::cacheKey() const
+{
+    std::shared_ptr<SDE> bounded = model ? model : fdm->model();
+    std::string componentKey = model ? model->key() : fdm->key(); // The FDM key includes its SDE's
+    std::string rngKey = rng->key();
+    if ((model && model->simulatesPaths()) || !bounded || componentKey.empty() || rngKey.empty())
+    {
+        return ""; // Model state or unknown components: the key would not determine the paths
+    }
+    std::ostringstream out;
+    out << kernels().name << '|' << componentKey << '|' << static_cast<int>(bounded->boundary()) << '|' << rngKey << '|'
+        << M << '|' << blockSize << '|' << fixedWidth << '|' << std::hexfloat << S0; // Block size fixes which normals go to which path
+    for (double t : grid)
+    {
+        out << ':' << t;
+    }
+    return out.str();
+}
+
+Generator<PathBlock> PathGenerator::blocks()
+{
+    PathBlock block(fixedWidth ? blockSize : std::min<std::size_t>(blockSize, M), grid); // Reused for every block
+    std::vector<double> dW(block.size()); // Normals, then Wiener increments, for one time step
+    bool pathwise = model && model->simulatesPaths(); // The model fills whole blocks itself
+    std::size_t steps = pathwise ? 0 : grid.size() - 1; // Time steps taken here
+    std::shared_ptr<SDE> bounded = model ? model : fdm->model(); // Model whose boundary policy applies to the steps taken here
+    std::size_t rows = grid.size();
+
+    std::string key = cache ? cacheKey() : "";
+    std::shared_ptr<const CachedChunk> cached = key.empty() ? nullptr : cache->find(key);
+    if (cached && (cached->rows != rows || cached->paths != static_cast<std::size_t>(M)))
+    {
+        cached = nullptr; // Cannot happen for equal keys; simulate rather than trust it
+    }
+    if (cached)
+    {
+        for (int produced = 0; produced < M; )
+        {
+            std::size_t n = std::min<std::size_t>(blockSize, M - produced);
+            block.resize(n);
+            for (std::size_t j = 0; j < rows; ++j)
+            {
+                std::memcpy(block.row(j), cached->values + j * M + produced, n * sizeof(double)); // Chunk rows are time-major over all paths
+            }
+            std::memcpy(block.rejected(), cached->rejected + produced, n);
+            block.setLogSums(false);
+            produced += static_cast<int>(n);
+            co_yield block;
+        }
+        if (bounded)
+        {
+            bounded->countBoundary(cached->fired, cached->dropped);
+        }
+        co_return;
+    }
+
+    std::vector<double> stored(key.empty() ? 0 : rows * M); // Whole chunk, time-major, for the cache
+    std::vector<std::uint8_t> storedRejected(key.empty() ? 0 : M);
+    std::uint64_t totalFired = 0, totalDropped = 0;
+
+    for (int produced = 0; produced < M; )
+    {
+        std::size_t n = std::min<std::size_t>(blockSize, M - produced); // The last block may be partial
+        std::size_t width = fixedWidth ? blockSize : n; // Paths simulated, of which the first n are yielded
+        block.resize(width);
+
+        double* first = block.row(0);
+        std::fill(first, first + width, S0); // Every path starts at S0
+        std::uint8_t* rejected = block.rejected();
+        std::fill(rejected, rejected + width, std::uint8_t(0));
+        block.setLogSums(false); // Only producers that step log S record the sums
+        std::uint64_t fired = 0; // Steps of this block that landed below zero
+
+        if (pathwise)
+        {
+            model->simulateBlock(block, *rng); // The model fills the whole block itself
+        }
+
+        for (std::size_t j = 0; j < steps; ++j) // Loop over time steps
+        {
+            double t = grid[j];
+            double dt = grid[j + 1] - t;
+            double* next = block.row(j + 1);
+
+            if (model)
+            {
+                model->sampleTransition(block.row(j), next, width, t, dt, *rng, dW.data()); // Sample the next date exactly
+            }
+            else
+            {
+                rng->generateStep(dW.data(), width); // One RNG call per step for the whole block
+                kernels().scale(dW.data(), width, std::sqrt(dt)); // Scale from standard normals to Wiener increments
+                fdm->advanceBlock(block.row(j), next, width, t, dt, dW.data()); // Advance every path in the block
+            }
+
+            if (bounded)
+            {
+                fired += bounded->applyBoundary(block.row(j), next, n, rejected); // Absorb, reflect, truncate or reject
+                if (width > n)
+                {
+                    bounded->applyBoundary(block.row(j) + n, next + n, width - n, rejected + n); // Extra lanes: bounded but not counted
+                }
+            }
+        }
+
+        if (bounded && steps > 0)
+        {
+            std::uint64_t dropped = 0;
+            for (std::size_t p = 0; p < n; ++p)
+            {
+                dropped += rejected[p];
+            }
+            bounded->countBoundary(fired, dropped); // One pair of atomic updates per block
+            totalFired += fired;
+            totalDropped += dropped;
+        }
+
+        if (!stored.empty())
+        {
+            for (std::size_t j = 0; j < rows; ++j)
+            {
+                std::copy_n(block.row(j), n, stored.data() + j * M + produced);
+            }
+            std::copy_n(rejected, n, storedRejected.data() + produced);
+        }
+
+        block.resize(n);
+        produced += static_cast<int>(n);
+        co_yield block; // Suspend until the consumer asks for the next block
+    }
+
+    if (!stored.empty())
+    {
+        cache->publish(key, stored.data(), storedRejected.data(), rows, M, totalFired, totalDropped); // Best effort: a full cache skips it
+    }
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+/*
+ * File: PathGenerator.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the PathGenerator class, a lazy producer of simulated price paths. The generator drives the
+ * FDM scheme (and through it the SDE) with normals drawn from the RNG, one PathBlock at a time, and hands each block
+ * to the consumer through a C++20 coroutine. Consumers such as payoff accumulators or path exporters simply iterate
+ * over blocks() and never see the whole simulation in memory. Random numbers and FDM steps are processed per block,
+ * so the cost of suspending and resuming the coroutine is paid once per block rather than once per time step.
+ * A generator built from an SDE with an exact transition law skips the N-step grid altogether: it samples each path
+ * only at the requested observation dates, drawing every date from its exact conditional distribution given the
+ * previous one, so the work per path is the number of dates rather than N. Non-Markovian models that simulate
+ * whole paths themselves (rough Bergomi) fill each block through SDE::simulateBlock on the uniform N-step grid.
+ * With a PathCache attached, a generator whose paths are fully described by the keys of its components looks its
+ * paths up in the cache first and copies the stored rows into its blocks; otherwise it simulates them and stores
+ * them for other processes once the last block has been produced.
+ * At fixed width every block is simulated at the full block size even when fewer paths are needed, so the numbers
+ * drawn for a path depend only on its position and not on how many paths were requested.
+ */
+
+#ifndef PATHGENERATOR_HPP
+#define PATHGENERATOR_HPP
+
+#include <memory>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "SDE.hpp"
+#include "FDM.hpp"
+#include "RNG.hpp"
+#include "PathBlock.hpp"
+#include "Generator.hpp"
+#include "PathCache.hpp"
+
+class PathGenerator
+{
+private:
+    std::shared_ptr<FDM> fdm; // Finite Difference Method used to step the paths (null in exact mode)
+    std::shared_ptr<SDE> model; // SDE that samples exact transitions or whole paths itself (null in FDM mode)
+    std::shared_ptr<RNG> rng; // Random Number Generator for the Wiener increments
+    double S0; // Initial stock price
+    std::vector<double> grid; // Simulated times, starting at 0
+    int M;     // Total number of paths to produce
+    std::size_t blockSize; // Maximum number of paths per block
+    bool fixedWidth; // Simulate every block at the full block size
+    std::shared_ptr<PathCache> cache; // Shared store of the paths of freshly seeded generators (null if not used)
+
+    std::string cacheKey() const; // Exact description of the paths this generator produces (empty if they cannot be shared)
+
+public:
+    static constexpr std::size_t defaultBlockSize = 256; // Paths per block unless specified otherwise
+
+    PathGenerator(std::shared_ptr<FDM> fdm, std::shared_ptr<RNG> rng, double S0, double T, int N, int M,
+        std::size_t blockSize = defaultBlockSize); // Constructor, steps the uniform N-step grid with the FDM scheme
+    PathGenerator(std::shared_ptr<SDE> sde, std::shared_ptr<RNG> rng, double S0, const std::vector<double>& dates, int M,
+        std::size_t blockSize = defaultBlockSize); // Constructor, samples only the increasing observation dates exactly
+    PathGenerator(std::shared_ptr<SDE> sde, std::shared_ptr<RNG> rng, double S0, double T, int N, int M,
+        std::size_t blockSize = defaultBlockSize); // Constructor, lets a path-simulating SDE fill the uniform N-step grid
+
+    // Share the paths through cache. The RNG must be freshly seeded (a stream), since its key describes its sequence
+    // from the seed on; paths of models that simulate themselves, or of components without keys, are not shared.
+    void useCache(std::shared_ptr<PathCache> cache);
+    void setFixedWidth(bool fixed); // Simulate partial blocks at full width and yield only the paths asked for
+
+    // Lazily yield blocks until M paths have been produced. The same PathBlock is reused for every yield, so a
+    // block is only valid until the consumer advances. The PathGenerator must outlive the returned Generator.
+    Generator<PathBlock> blocks();
+};
+
+#endif // PATHGENERATOR_HPP
\ No newline at end of file
@@ -8,15 +8,60 @@
  * for calculating the payoff of European options, Barrier options, and Asian options. Each class implements
  * the payoff calculation based on the option type, strike price, and other parameters. These implementations
  * are crucial for pricing financial derivatives and simulating their behavior under different market conditions.
+ * Block evaluation of European and barrier payoffs uses the runtime-dispatched SIMD kernels.
  */
 
 #include "Payoff.hpp"
+#include "Dispatch.hpp"
+#include <stdexcept>
+
+// Continuous approximation of the step 1{x > 0}: linear from 0 to 1 over [-width, width]; slope receives its derivative
+static double ramp(double x, double width, double& slope)
+{
+    if (x <= -width || x >= width)
+    {
+        slope = 0.0;
+        return x > 0 ? 1.0 : 0.0;
+    }
+    slope = 0.5 / width;
+    return 0.5 + 0.5 * x / width;
+}
+
+void Payoff::evaluateBlock(const PathBlock& block, double* out) const
+{
+    const double* ST = block.terminal(); // Standard options only need the terminal prices
+    for (std::size_t p = 0; p < block.size(); ++p)
+    {
+        out[p] = (*this)(ST[p]);
+    }
+}
+
+std::vector<double> Payoff::observationTimes(double T) const
+{
+    return {}; // Conservative default: the payoff may look at every step
+}
+
+double Payoff::localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const
+{
+    gradient.assign(path.size(), 0.0); // No smooth part: the whole payoff is carried by the weights
+    return 0.0;
+}
+
+bool Payoff::vanilla(double& K, bool& isCall) const
+{
+    return false; // Exotic or unknown payoffs need simulation
+}
+
+bool Payoff::barrier(double& K, double& B, bool& isCall, bool& isUp, bool& isIn) const
+{
+    return false;
+}
 
 EuropeanCall::EuropeanCall(double K) : K(K) {}
 
 double EuropeanCall::operator()(double S) const
 {
-    return std::max(S - K, 0.0); // Payoff for European Call: max(S - K, 0)
+    return value(S); // Payoff for European Call: max(S - K, 0)
 }
 
 double EuropeanCall::operator()(const std::vector<double>& path) const
@@ -24,11 +69,35 @@ double EuropeanCall::operator()(const std::vector<double>& path) const
     return (*this)(path.back()); // Use the last price in the path for payoff calculation
 }
 
+void EuropeanCall::evaluateBlock(const PathBlock& block, double* out) const
+{
+    kernels().callPayoff(block.terminal(), out, block.size(), K);
+}
+
+std::vector<double> EuropeanCall::observationTimes(double T) const
+{
+    return { T };
+}
+
+double EuropeanCall::localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const
+{
+    gradient.assign(path.size(), 0.0);
+    gradient.back() = path.back() > K ? 1.0 : 0.0;
+    return (*this)(path.back());
+}
+
+bool EuropeanCall::vanilla(double& K, bool& isCall) const
+{
+    K = this->K;
+    isCall = true;
+    return true;
+}
+
 EuropeanPut::EuropeanPut(double K) : K(K) {}
 
 double EuropeanPut::operator()(double S) const
 {
-    return std::max(K - S, 0.0); // Payoff for European Put: max(K - S, 0)
+    return value(S); // Payoff for European Put: max(K - S, 0)
 }
 
 double EuropeanPut::operator()(const std::vector<double>& path) const
@@ -36,40 +105,124 @@ double EuropeanPut::operator()(const std::vector<double>& path) const
     return (*this)(path.back()); // Use the last price in the path for payoff calculation
 }
 
-BarrierOption::BarrierOption(double K, double B, bool isCall, bool isUp, bool isIn)
-    : K(K), B(B), isCall(isCall), isUp(isUp), isIn(isIn)
+void EuropeanPut::evaluateBlock(const PathBlock& block, double* out) const
+{
+    kernels().putPayoff(block.terminal(), out, block.size(), K);
+}
+
+std::vector<double> EuropeanPut::observationTimes(double T) const
+{
+    return { T };
+}
+
+double EuropeanPut::localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const
+{
+    gradient.assign(path.size(), 0.0);
+    gradient.back() = path.back() < K ? -1.0 : 0.0;
+    return (*this)(path.back());
+}
+
+bool EuropeanPut::vanilla(double& K, bool& isCall) const
+{
+    K = this->K;
+    isCall = false;
+    return true;
+}
+
+template <bool isCall, bool isUp, bool isIn>
+BarrierOption<isCall, isUp, isIn>::BarrierOption(double K, double B) : K(K), B(B)
+{
+}
+
+template <bool isCall, bool isUp, bool isIn>
+double BarrierOption<isCall, isUp, isIn>::settle(double S, double extreme, double K, double B)
 {
+    bool hit = isUp ? (extreme >= B) : (extreme <= B); // Was the barrier touched?
+    double intrinsic = isCall ? std::max(S - K, 0.0) : std::max(K - S, 0.0); // Payoff of the underlying call or put
+    return (hit == isIn) ? intrinsic : 0.0; // In: pays only if hit; Out: pays only if not hit (a select, not a branch)
 }
 
-double BarrierOption::operator()(double S) const
+template <bool isCall, bool isUp, bool isIn>
+double BarrierOption<isCall, isUp, isIn>::operator()(double S) const
 {
-    bool isBarrierHit = (isUp) ? (S >= B) : (S <= B); // Check if the barrier is hit
+    return settle(S, S, K, B); // A single price is its own extreme
+}
 
-    if (isIn)
+template <bool isCall, bool isUp, bool isIn>
+double BarrierOption<isCall, isUp, isIn>::operator()(const std::vector<double>& path) const
+{
+    double extreme = path.front();
+    for (double price : path)
     {
-        // In barrier: payoff only if barrier is hit
-        if (!isBarrierHit)
-            return 0.0;
+        extreme = isUp ? std::max(extreme, price) : std::min(extreme, price); // Running maximum (up) or minimum (down)
     }
-    else
+    return settle(path.back(), extreme, K, B);
+}
+
+template <bool isCall, bool isUp, bool isIn>
+void BarrierOption<isCall, isUp, isIn>::evaluateBlock(const PathBlock& block, double* out) const
+{
+    std::size_t n = block.size();
+    const double* first = block.row(0);
+    std::copy(first, first + n, out); // out holds the running extreme of each path
+
+    const KernelTable& kernel = kernels();
+    for (std::size_t j = 1; j <= block.numSteps(); ++j)
     {
-        // Out barrier: payoff only if barrier is not hit
-        if (isBarrierHit)
-            return 0.0;
+        (isUp ? kernel.runningMax : kernel.runningMin)(out, block.row(j), n); // Contiguous across paths: vector max/min
     }
+    kernel.barrierSettle(block.terminal(), out, n, K, B, isCall, isUp, isIn); // Vector compare and select under the hit mask
+}
 
-    // Calculate payoff based on call/put
-    if (isCall)
-        return std::max(S - K, 0.0); // Payoff for Barrier Call: max(S - K, 0)
-    else
-        return std::max(K - S, 0.0); // Payoff for Barrier Put: max(K - S, 0)
+template <bool isCall, bool isUp, bool isIn>
+double BarrierOption<isCall, isUp, isIn>::localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const
+{
+    std::size_t n = path.size();
+    double slope;
+    gradient.resize(n);
+    double survival = 1.0; // Forward pass: gradient[j] holds the product of the survival ramps before point j
+    for (std::size_t j = 0; j < n; ++j)
+    {
+        gradient[j] = survival;
+        survival *= ramp(isUp ? B - path[j] : path[j] - B, j == 0 ? 0.0 : width, slope); // The initial price is checked exactly
+    }
+
+    double S = path.back();
+    double intrinsic = isCall ? std::max(S - K, 0.0) : std::max(K - S, 0.0);
+    double intrinsicSlope = isCall ? (S > K ? 1.0 : 0.0) : (S < K ? -1.0 : 0.0);
+    double after = 1.0; // Backward pass: product of the survival ramps after point j
+    for (std::size_t j = n; j-- > 0;)
+    {
+        double h = ramp(isUp ? B - path[j] : path[j] - B, j == 0 ? 0.0 : width, slope);
+        double dOut = intrinsic * gradient[j] * after * (isUp ? -slope : slope); // Derivative of intrinsic * survival
+        gradient[j] = isIn ? -dOut : dOut; // Knock-in = intrinsic - knock-out
+        after *= h;
+    }
+    gradient.back() += isIn ? intrinsicSlope * (1.0 - survival) : intrinsicSlope * survival;
+    return isIn ? intrinsic * (1.0 - survival) : intrinsic * survival;
 }
 
-double BarrierOption::operator()(const std::vector<double>& path) const
+template <bool isCall, bool isUp, bool isIn>
+bool BarrierOption<isCall, isUp, isIn>::barrier(double& K, double& B, bool& call, bool& up, bool& in) const
 {
-    return (*this)(path.back()); // Use the last price in the path for payoff calculation
+    K = this->K;
+    B = this->B;
+    call = isCall;
+    up = isUp;
+    in = isIn;
+    return true;
 }
 
+// The eight barrier variants, selected once when the payoff is built
+template class BarrierOption<true, true, true>;     // Up-and-In Call
+template class BarrierOption<false, true, true>;    // Up-and-In Put
+template class BarrierOption<true, true, false>;    // Up-and-Out Call
+template class BarrierOption<false, true, false>;   // Up-and-Out Put
+template class BarrierOption<true, false, true>;    // Down-and-In Call
+template class BarrierOption<false, false, true>;   // Down-and-In Put
+template class BarrierOption<true, false, false>;   // Down-and-Out Call
+template class BarrierOption<false, false, false>;  // Down-and-Out Put
+
 AsianOption::AsianOption(double K, bool isCall) : K(K), isCall(isCall) {}
 
 double AsianOption::operator()(double S) const
@@ -78,18 +231,153 @@ double AsianOption::operator()(double S) const
     return 0.0;
 }
 
+double AsianOption::settle(double average) const
+{
+    return isCall ? std::max(average - K, 0.0) : std::max(K - average, 0.0);
+}
+
 double AsianOption::operator()(const std::vector<double>& path) const
 {
-    // Calculate the geometric average of the price path
-    double logSum = 0.0;
-    for (double price : path)
+    double mantissa = 1.0;
+    int exponent = 0;
+    for (std::size_t j = 0; j < path.size(); ++j)
+    {
+        mantissa *= path[j];
+        if ((j + 1) % renormalisation == 0)
+        {
+            int e;
+            mantissa = std::frexp(mantissa, &e); // Move the exponent out before the product can overflow
+            exponent += e;
+        }
+    }
+    double logAverage = (std::log(mantissa) + exponent * std::log(2.0)) / path.size();
+    return settle(std::exp(logAverage)); // Geometric average payoff
+}
+
+void AsianOption::evaluateBlock(const PathBlock& block, double* out) const
+{
+    std::size_t n = block.size();
+    std::size_t rows = block.numSteps() + 1; // The average includes S0
+    if (block.hasLogSums())
+    {
+        const double* logSums = block.logSums(); // Recorded by a producer that steps log S
+        for (std::size_t p = 0; p < n; ++p)
+        {
+            out[p] = settle(std::exp(logSums[p] / rows));
+        }
+        return;
+    }
+
+    std::vector<int> exponent(n, 0); // Binary exponents taken out of the running products
+    std::fill(out, out + n, 1.0); // Running products, kept in out
+    for (std::size_t j = 0; j < rows; ++j)
+    {
+        const double* row = block.row(j);
+        for (std::size_t p = 0; p < n; ++p)
+        {
+            out[p] *= row[p]; // Contiguous across paths
+        }
+        if ((j + 1) % renormalisation == 0)
+        {
+            for (std::size_t p = 0; p < n; ++p)
+            {
+                int e;
+                out[p] = std::frexp(out[p], &e);
+                exponent[p] += e;
+            }
+        }
+    }
+    for (std::size_t p = 0; p < n; ++p)
+    {
+        out[p] = settle(std::exp((std::log(out[p]) + exponent[p] * std::log(2.0)) / rows));
+    }
+}
+
+double AsianOption::localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const
+{
+    double payoff = (*this)(path);
+    double average = isCall ? payoff + K : K - payoff; // Geometric average when in the money
+    double slope = payoff > 0 ? (isCall ? 1.0 : -1.0) * average / path.size() : 0.0;
+    gradient.resize(path.size());
+    for (std::size_t j = 0; j < path.size(); ++j)
+    {
+        gradient[j] = slope / path[j]; // d average / d path[j] = average / (n * path[j])
+    }
+    return payoff;
+}
+
+DiscreteAsianOption::DiscreteAsianOption(double K, bool isCall, const std::vector<double>& dates)
+    : K(K), isCall(isCall), dates(dates)
+{
+    if (dates.empty())
+    {
+        throw std::invalid_argument("DiscreteAsianOption needs at least one fixing date.");
+    }
+    for (std::size_t i = 0; i < dates.size(); ++i)
     {
-        logSum += std::log(price);
+        if (dates[i] <= 0 || (i > 0 && dates[i] <= dates[i - 1]))
+        {
+            throw std::invalid_argument("Fixing dates must be positive and strictly increasing.");
+        }
     }
-    double geometricAverage = std::exp(logSum / path.size());
+}
+
+double DiscreteAsianOption::operator()(double S) const
+{
+    return isCall ? std::max(S - K, 0.0) : std::max(K - S, 0.0); // Average of a single fixing
+}
+
+double DiscreteAsianOption::operator()(const std::vector<double>& path) const
+{
+    double average = std::accumulate(path.begin(), path.end(), 0.0) / path.size(); // Arithmetic average of the fixings
+    return (*this)(average);
+}
+
+void DiscreteAsianOption::evaluateBlock(const PathBlock& block, double* out) const
+{
+    std::size_t n = block.size();
+    std::fill(out, out + n, 0.0);
+    for (double t : dates)
+    {
+        const double* fixing = block.row(block.rowAt(t)); // Works on the full grid and on a grid of observation dates
+        for (std::size_t p = 0; p < n; ++p)
+        {
+            out[p] += fixing[p];
+        }
+    }
+    for (std::size_t p = 0; p < n; ++p)
+    {
+        out[p] = (*this)(out[p] / dates.size());
+    }
+}
 
-    if (isCall)
-        return std::max(geometricAverage - K, 0.0); // Payoff for Asian Call: max(average - K, 0)
-    else
-        return std::max(K - geometricAverage, 0.0); // Payoff for Asian Put: max(K - average, 0)
+std::vector<double> DiscreteAsianOption::observationTimes(double T) const
+{
+    return dates;
+}
+
+DigitalOption::DigitalOption(double K, bool isCall) : K(K), isCall(isCall) {}
+
+double DigitalOption::operator()(double S) const
+{
+    return (isCall ? S > K : S < K) ? 1.0 : 0.0; // One unit of cash if the option finishes in the money
+}
+
+double DigitalOption::operator()(const std::vector<double>& path) const
+{
+    return (*this)(path.back()); // Use the last price in the path for payoff calculation
+}
+
+std::vector<double> DigitalOption::observationTimes(double T) const
+{
+    return { T };
+}
+
+double DigitalOption::localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const
+{
+    double slope;
+    double h = ramp(isCall ? path.back() - K : K - path.back(), width, slope);
+    gradient.assign(path.size(), 0.0);
+    gradient.back() = isCall ? slope : -slope;
+    return h;
 }
\ No newline at end of file
@@ -9,6 +9,21 @@
  * standard and path-dependent options. Derived classes include EuropeanCall, EuropeanPut, BarrierOption,
  * and AsianOption, each implementing specific payoff calculations for different types of options.
  * These classes are essential for pricing and simulating financial derivatives in quantitative finance.
+ * BarrierOption is a class template on its call/put, up/down and in/out flags. The eight variants are explicitly
+ * instantiated in Payoff.cpp, so every flag is resolved at compile time and the barrier is monitored over whole
+ * path blocks with branch-free running extremes and masks.
+ * A payoff that only looks at a few dates reports them through observationTimes(); if the model has an exact
+ * transition law the solver then simulates those dates only. DiscreteAsianOption averages over such dates.
+ * EuropeanCall and EuropeanPut also provide value() templates over the scalar type, which the virtual operators use
+ * in double precision and the forward-mode Greeks engine uses with Dual numbers. AsianOption's value() template is
+ * kept for Dual numbers; in double precision the geometric average is a running product whose exponent is taken
+ * out with frexp every few points, so a path costs one log and one exp instead of one log per point, and none at
+ * all when the producer already recorded the sum of log S in the block.
+ * DigitalOption pays one unit of cash. For the Malliavin Greeks engine a payoff can split itself through localised()
+ * into a smooth part, differentiated pathwise, and a remainder that vanishes away from its discontinuities, which
+ * is the only part multiplied by the high-variance weights.
+ * vanilla() and barrier() let engines that do not simulate paths (the Fourier and lattice pricers) recognise the
+ * contracts they can price directly.
  */
 
 #ifndef PAYOFF_HPP
@@ -19,6 +34,7 @@
 #include <cmath>
 #include <algorithm>
 #include <numeric>
+#include "PathBlock.hpp"
 
 class Payoff
 {
@@ -26,6 +42,13 @@ public:
     virtual ~Payoff() = default;
     virtual double operator()(double S) const = 0; // Payoff function for standard options (single price)
     virtual double operator()(const std::vector<double>& path) const = 0; // Payoff function for path-dependent options (price path)
+    virtual void evaluateBlock(const PathBlock& block, double* out) const; // Payoffs of every path in a block (terminal price by default)
+    virtual std::vector<double> observationTimes(double T) const; // Dates the payoff looks at (empty if it needs the full grid)
+    // Smooth part of the payoff on a full-grid path, equal to it outside a band of half-width width around each
+    // discontinuity; writes its derivative with respect to every path point into gradient (default: zero everywhere)
+    virtual double localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const;
+    virtual bool vanilla(double& K, bool& isCall) const; // True for a European call or put, which also reports its strike and type
+    virtual bool barrier(double& K, double& B, bool& isCall, bool& isUp, bool& isIn) const; // True for a barrier option, which also reports its terms
 };
 
 class EuropeanCall : public Payoff
@@ -35,8 +58,14 @@ private:
 
 public:
     EuropeanCall(double K); // Constructor for European Call option
+    template <typename Real> Real value(const Real& S) const; // Payoff for a single price over any scalar type
+    template <typename Real> Real value(const std::vector<Real>& path) const; // Payoff for a price path over any scalar type
     double operator()(double S) const override; // Payoff for a single price
     double operator()(const std::vector<double>& path) const override; // Payoff for a price path
+    void evaluateBlock(const PathBlock& block, double* out) const override; // Batch kernel on the terminal prices
+    std::vector<double> observationTimes(double T) const override; // Maturity only
+    double localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const override; // The payoff itself (continuous)
+    bool vanilla(double& K, bool& isCall) const override; // A call with strike K
 };
 
 class EuropeanPut : public Payoff
@@ -46,23 +75,32 @@ private:
 
 public:
     EuropeanPut(double K); // Constructor for European Put option
+    template <typename Real> Real value(const Real& S) const; // Payoff for a single price over any scalar type
+    template <typename Real> Real value(const std::vector<Real>& path) const; // Payoff for a price path over any scalar type
     double operator()(double S) const override; // Payoff for a single price
     double operator()(const std::vector<double>& path) const override; // Payoff for a price path
+    void evaluateBlock(const PathBlock& block, double* out) const override; // Batch kernel on the terminal prices
+    std::vector<double> observationTimes(double T) const override; // Maturity only
+    double localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const override; // The payoff itself (continuous)
+    bool vanilla(double& K, bool& isCall) const override; // A put with strike K
 };
 
+template <bool isCall, bool isUp, bool isIn> // Call or put, up or down barrier, knock-in or knock-out
 class BarrierOption : public Payoff
 {
 private:
     double K; // Strike price
     double B; // Barrier level
-    bool isCall; // True for call option, false for put option
-    bool isUp; // True for up barrier, false for down barrier
-    bool isIn; // True for in barrier, false for out barrier
+
+    static double settle(double S, double extreme, double K, double B); // Payoff at terminal price S given the running extreme of the path
 
 public:
-    BarrierOption(double K, double B, bool isCall, bool isUp, bool isIn); // Constructor for Barrier option
-    double operator()(double S) const override; // Payoff for a single price
-    double operator()(const std::vector<double>& path) const override; // Payoff for a price path
+    BarrierOption(double K, double B); // Constructor for Barrier option
+    double operator()(double S) const override; // Payoff for a single price (barrier observed at that price only)
+    double operator()(const std::vector<double>& path) const override; // Payoff for a price path (barrier observed at every step)
+    void evaluateBlock(const PathBlock& block, double* out) const override; // Payoffs of every path in a block
+    double localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const override; // Barrier indicators replaced by ramps
+    bool barrier(double& K, double& B, bool& call, bool& up, bool& in) const override; // The template flags and levels
 };
 
 class AsianOption : public Payoff
@@ -71,10 +109,88 @@ private:
     double K; // Strike price
     bool isCall; // True for call option, false for put option
 
+    double settle(double average) const; // Payoff on a geometric average
+
 public:
+    static constexpr std::size_t renormalisation = 16; // Points multiplied between frexp calls: safe for 2^-63 < S < 2^63
+
     AsianOption(double K, bool isCall); // Constructor for Asian option
+    template <typename Real> Real value(const std::vector<Real>& path) const; // Payoff for a price path over any scalar type
     double operator()(double S) const override; // Payoff for a single price (not applicable for Asian options)
     double operator()(const std::vector<double>& path) const override; // Payoff for a price path
+    void evaluateBlock(const PathBlock& block, double* out) const override; // Payoffs of every path in a block
+    double localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const override; // The payoff itself (continuous)
 };
 
+class DiscreteAsianOption : public Payoff
+{
+private:
+    double K; // Strike price
+    bool isCall; // True for call option, false for put option
+    std::vector<double> dates; // Fixing dates, strictly increasing
+
+public:
+    DiscreteAsianOption(double K, bool isCall, const std::vector<double>& dates); // Constructor for discretely fixed Asian option
+    double operator()(double S) const override; // Payoff for a single price (a single fixing)
+    double operator()(const std::vector<double>& path) const override; // Payoff for prices observed on the fixing dates
+    void evaluateBlock(const PathBlock& block, double* out) const override; // Arithmetic average of the fixing rows
+    std::vector<double> observationTimes(double T) const override; // The fixing dates
+};
+
+class DigitalOption : public Payoff
+{
+private:
+    double K; // Strike price
+    bool isCall; // True for call option, false for put option
+
+public:
+    DigitalOption(double K, bool isCall); // Constructor for cash-or-nothing Digital option
+    double operator()(double S) const override; // Pays 1 if the price finishes beyond the strike
+    double operator()(const std::vector<double>& path) const override; // Use the last price in the path
+    std::vector<double> observationTimes(double T) const override; // Maturity only
+    double localised(const std::vector<double>& path, double width, std::vector<double>& gradient) const override; // Step replaced by a ramp
+};
+
+template <typename Real>
+Real EuropeanCall::value(const Real& S) const
+{
+    return S > K ? S - K : Real(0.0); // max(S - K, 0)
+}
+
+template <typename Real>
+Real EuropeanCall::value(const std::vector<Real>& path) const
+{
+    return value(path.back());
+}
+
+template <typename Real>
+Real EuropeanPut::value(const Real& S) const
+{
+    return S < K ? K - S : Real(0.0); // max(K - S, 0)
+}
+
+template <typename Real>
+Real EuropeanPut::value(const std::vector<Real>& path) const
+{
+    return value(path.back());
+}
+
+template <typename Real>
+Real AsianOption::value(const std::vector<Real>& path) const
+{
+    using std::exp;
+    using std::log;
+    Real logSum(0.0);
+    for (const Real& price : path)
+    {
+        logSum += log(price);
+    }
+    Real average = exp(logSum / static_cast<double>(path.size())); // Geometric average of the price path
+
+    if (isCall)
+        return average > K ? average - K : Real(0.0); // Payoff for Asian Call: max(average - K, 0)
+    else
+        return average < K ? K - average : Real(0.0); // Payoff for Asian Put: max(K - average, 0)
+}
+
 #endif // PAYOFF_HPP
\ No newline at end of file
@@ -8,16 +8,424 @@
  * for the MersenneTwister class, which generates random numbers using the Mersenne Twister algorithm.
  * The generate() method returns a random number from a standard normal distribution (mean 0.0, standard deviation 1.0).
  * This implementation is essential for simulations and stochastic processes where high-quality random numbers are required.
+ * PipelinedRNG overlaps random number generation with path stepping: the producer thread keeps the ring full while
+ * the simulation thread only copies ready-made numbers, so the two phases run on separate cores. A generator that is
+ * only split never draws, so it never starts a producer; each of its streams starts one for its own chunk.
+ * Gamma samples use the Marsaglia-Tsang squeeze and inverse Gaussian samples the Michael-Schucany-Haas transform.
+ * Both are batched: a whole block of candidates is computed in one branch-free pass, and only the few rejected
+ * gamma candidates are compacted and redrawn. Uniforms are obtained from normals through the normal CDF.
+ * Poisson counts invert the CDF from one uniform each, which costs O(mean) per count; the jump counts of a time step
+ * have small means.
+ * MomentMatchedRNG sums a cross-section in a fixed scalar order, so the matched numbers do not depend on the instruction set,
+ * and then applies the affine map z -> (z - mean) / sd with one vector kernel.
  */
 
 #include "RNG.hpp"
+#include "Dispatch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+static double normalCdf(double z)
+{
+    return 0.5 * std::erfc(-z * 0.7071067811865476); // Turns a standard normal into a uniform on (0, 1)
+}
+
+void RNG::generateBlock(double* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        out[i] = generate(); // Default: one virtual call per number
+    }
+}
+
+void RNG::generateStep(double* out, std::size_t n)
+{
+    generateBlock(out, n); // A cross-section is an ordinary block unless a generator treats it specially
+}
+
+std::shared_ptr<RNG> RNG::stream(std::uint64_t index, std::uint64_t epoch) const
+{
+    return nullptr; // By default a generator cannot be split, and the solver runs it on a single thread
+}
+
+std::shared_ptr<RNG> RNG::stream(std::uint64_t index) const
+{
+    return stream(index, epoch());
+}
+
+std::uint64_t RNG::epoch() const
+{
+    return 0;
+}
+
+std::uint64_t RNG::nextEpoch()
+{
+    return 0; // Generators that cannot be split advance as they are drawn from
+}
+
+std::string RNG::key() const
+{
+    return ""; // Unknown generators are never shared
+}
+
+void RNG::generateGamma(double* out, std::size_t n, double shape, double scale)
+{
+    if (shape <= 0 || scale <= 0)
+    {
+        throw std::invalid_argument("Gamma shape and scale must be positive.");
+    }
+
+    double a = shape < 1 ? shape + 1 : shape; // Small shapes: Gamma(shape) = Gamma(shape + 1) * U^(1 / shape)
+    double d = a - 1.0 / 3.0;
+    double c = 1.0 / std::sqrt(9.0 * d);
+    std::vector<std::size_t> pending(n); // Samples still to be accepted
+    std::iota(pending.begin(), pending.end(), 0);
+    std::vector<double> draws(2 * n);
+
+    while (!pending.empty())
+    {
+        std::size_t m = pending.size();
+        generateBlock(draws.data(), 2 * m); // One normal for the candidate and one for the uniform of each sample
+        std::size_t kept = 0;
+        for (std::size_t k = 0; k < m; ++k)
+        {
+            double x = draws[k];
+            double v = 1.0 + c * x;
+            double v3 = v > 0 ? v * v * v : 1.0; // Any positive value: the candidate is rejected below
+            bool accepted = v > 0 && std::log(normalCdf(draws[m + k])) < 0.5 * x * x + d - d * v3 + d * std::log(v3);
+            out[pending[k]] = d * v3 * scale;
+            pending[kept] = pending[k];
+            kept += !accepted; // Compact the rejected samples to the front
+        }
+        pending.resize(kept);
+    }
+
+    if (shape < 1)
+    {
+        generateBlock(draws.data(), n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            out[i] *= std::pow(normalCdf(draws[i]), 1.0 / shape);
+        }
+    }
+}
+
+void RNG::generateInverseGaussian(double* out, std::size_t n, double mean, double shape)
+{
+    if (mean <= 0 || shape <= 0)
+    {
+        throw std::invalid_argument("Inverse Gaussian mean and shape must be positive.");
+    }
+
+    std::vector<double> draws(2 * n);
+    generateBlock(draws.data(), 2 * n);
+    for (std::size_t i = n; i < 2 * n; ++i)
+    {
+        draws[i] = normalCdf(draws[i]); // Second half: uniforms for the choice of root
+    }
+    kernels().inverseGaussian(draws.data(), draws.data() + n, out, n, mean, shape); // Both roots and the choice, branch-free
+}
+
+void RNG::generatePoisson(double* out, std::size_t n, double mean)
+{
+    if (mean < 0)
+    {
+        throw std::invalid_argument("Poisson mean must be non-negative.");
+    }
+
+    generateBlock(out, n);
+    double p0 = std::exp(-mean);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        double u = normalCdf(out[i]);
+        double k = 0, p = p0, F = p0; // Count, P(k) and P(<= k)
+        while (u > F && p > 0)
+        {
+            ++k;
+            p *= mean / k;
+            F += p;
+        }
+        out[i] = k;
+    }
+}
 
 MersenneTwister::MersenneTwister(unsigned int seed)
-    : generator(seed), distribution(0.0, 1.0) // Initialize the generator with the seed and set up the normal distribution
+    : lineage{ seed }, generator(seed), distribution(0.0, 1.0) // Initialize the generator with the seed and set up the normal distribution
 {
 }
 
+MersenneTwister::MersenneTwister(std::vector<unsigned int> lineage)
+    : lineage(std::move(lineage)), distribution(0.0, 1.0)
+{
+    std::seed_seq sequence(this->lineage.begin(), this->lineage.end());
+    generator.seed(sequence); // The whole state comes from the sequence, not from a single 32-bit seed
+}
+
 double MersenneTwister::generate()
 {
     return distribution(generator); // Generate and return a random number from the normal distribution
+}
+
+void MersenneTwister::generateBlock(double* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        out[i] = distribution(generator); // Draw directly from the distribution
+    }
+}
+
+std::string MersenneTwister::key() const
+{
+    std::string key = "MT19937:" + std::to_string(lineage[0]);
+    for (std::size_t i = 1; i + 3 < lineage.size(); i += 4) // One index@epoch pair per split: keys are as wide as the seed sequence
+    {
+        std::uint64_t index = lineage[i] | std::uint64_t(lineage[i + 1]) << 32;
+        std::uint64_t epoch = lineage[i + 2] | std::uint64_t(lineage[i + 3]) << 32;
+        key += "/" + std::to_string(index) + "@" + std::to_string(epoch);
+    }
+    return key;
+}
+
+std::shared_ptr<RNG> MersenneTwister::stream(std::uint64_t index, std::uint64_t epoch) const
+{
+    std::vector<unsigned int> split = lineage;
+    split.insert(split.end(), { static_cast<unsigned int>(index), static_cast<unsigned int>(index >> 32),
+        static_cast<unsigned int>(epoch), static_cast<unsigned int>(epoch >> 32) });
+    return std::shared_ptr<RNG>(new MersenneTwister(std::move(split))); // The stream constructor is private
+}
+
+std::uint64_t MersenneTwister::epoch() const
+{
+    return current.load(std::memory_order_relaxed);
+}
+
+std::uint64_t MersenneTwister::nextEpoch()
+{
+    return current.fetch_add(1, std::memory_order_relaxed);
+}
+
+PipelinedRNG::PipelinedRNG(std::shared_ptr<RNG> source, std::size_t slotSize, std::size_t slots)
+    : source(source), slotSize(slotSize), slots(slots), ring(slots, std::vector<double>(slotSize)), current(nullptr), position(0), stop(false)
+{
+    if (!source)
+    {
+        throw std::invalid_argument("Source RNG pointer is null in PipelinedRNG constructor.");
+    }
+    if (slotSize == 0)
+    {
+        throw std::invalid_argument("PipelinedRNG slot size must be positive.");
+    }
+}
+
+PipelinedRNG::~PipelinedRNG()
+{
+    stop.store(true, std::memory_order_relaxed);
+    if (producer.joinable())
+    {
+        producer.join();
+    }
+}
+
+void PipelinedRNG::produce()
+{
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        std::vector<double>* slot = ring.tryAcquireWrite();
+        if (!slot)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50)); // Ring is full: back off instead of burning the core
+            continue;
+        }
+        source->generateBlock(slot->data(), slot->size()); // Fill the slot in place
+        ring.commitWrite();
+    }
+}
+
+void PipelinedRNG::nextSlot()
+{
+    if (current)
+    {
+        ring.commitRead(); // Hand the exhausted slot back to the producer
+    }
+    else if (!producer.joinable())
+    {
+        producer = std::thread(&PipelinedRNG::produce, this); // First draw: start filling the ring
+    }
+    while (!(current = ring.tryAcquireRead()))
+    {
+        std::this_thread::yield(); // Ring is empty: the producer is the bottleneck
+    }
+    position = 0;
+}
+
+double PipelinedRNG::generate()
+{
+    if (!current || position == current->size())
+    {
+        nextSlot();
+    }
+    return (*current)[position++];
+}
+
+void PipelinedRNG::generateBlock(double* out, std::size_t n)
+{
+    while (n > 0)
+    {
+        if (!current || position == current->size())
+        {
+            nextSlot();
+        }
+        std::size_t count = std::min(n, current->size() - position); // Numbers available in this slot
+        std::copy_n(current->data() + position, count, out);
+        position += count;
+        out += count;
+        n -= count;
+    }
+}
+
+std::shared_ptr<RNG> PipelinedRNG::stream(std::uint64_t index, std::uint64_t epoch) const
+{
+    std::shared_ptr<RNG> split = source->stream(index, epoch); // Only reads the source's seed, so it does not disturb a running producer
+    return split ? std::make_shared<PipelinedRNG>(split, slotSize, slots) : nullptr;
+}
+
+std::uint64_t PipelinedRNG::epoch() const
+{
+    return source->epoch();
+}
+
+std::uint64_t PipelinedRNG::nextEpoch()
+{
+    return source->nextEpoch();
+}
+
+std::string PipelinedRNG::key() const
+{
+    return source->key();
+}
+
+ReplayRNG::ReplayRNG(std::size_t reserve) : position(0), source(nullptr)
+{
+    buffer.reserve(reserve);
+}
+
+void ReplayRNG::extend(std::size_t end)
+{
+    if (end <= buffer.size())
+    {
+        return;
+    }
+    if (!source)
+    {
+        throw std::logic_error("ReplayRNG has no source; call refill() first.");
+    }
+    std::size_t recorded = buffer.size();
+    buffer.resize(end);
+    source->generateBlock(buffer.data() + recorded, end - recorded); // One source call for the whole shortfall
+}
+
+void ReplayRNG::refill(RNG& source)
+{
+    this->source = &source;
+    buffer.clear(); // Keeps the capacity, so later recordings do not reallocate
+    position = 0;
+}
+
+void ReplayRNG::rewind()
+{
+    position = 0;
+}
+
+double ReplayRNG::generate()
+{
+    extend(position + 1);
+    return buffer[position++];
+}
+
+void ReplayRNG::generateBlock(double* out, std::size_t n)
+{
+    extend(position + n);
+    std::copy(buffer.begin() + position, buffer.begin() + position + n, out);
+    position += n;
+}
+
+MomentMatchedRNG::MomentMatchedRNG(std::shared_ptr<RNG> source) : source(source)
+{
+    if (!source)
+    {
+        throw std::invalid_argument("Source RNG pointer is null in MomentMatchedRNG constructor.");
+    }
+}
+
+double MomentMatchedRNG::generate()
+{
+    return source->generate();
+}
+
+void MomentMatchedRNG::generateBlock(double* out, std::size_t n)
+{
+    source->generateBlock(out, n); // Unknown layout: matching it could correlate numbers that must be independent
+}
+
+void MomentMatchedRNG::generateStep(double* out, std::size_t n)
+{
+    source->generateBlock(out, n);
+    if (n < 2)
+    {
+        return;
+    }
+    double sum = 0.0, squares = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        sum += out[i];
+        squares += out[i] * out[i];
+    }
+    double mean = sum / n;
+    double variance = squares / n - mean * mean; // Second central moment of the block
+    if (variance <= 0)
+    {
+        return; // Degenerate block: nothing to rescale
+    }
+    double factor = 1.0 / std::sqrt(variance);
+    kernels().affine(out, n, factor, -mean * factor);
+}
+
+std::shared_ptr<RNG> MomentMatchedRNG::stream(std::uint64_t index, std::uint64_t epoch) const
+{
+    std::shared_ptr<RNG> split = source->stream(index, epoch);
+    return split ? std::make_shared<MomentMatchedRNG>(split) : nullptr;
+}
+
+std::uint64_t MomentMatchedRNG::epoch() const
+{
+    return source->epoch();
+}
+
+std::uint64_t MomentMatchedRNG::nextEpoch()
+{
+    return source->nextEpoch();
+}
+
+std::string MomentMatchedRNG::key() const
+{
+    std::string sourceKey = source->key();
+    return sourceKey.empty() ? "" : "Matched(" + sourceKey + ")";
+}
+
+void MomentMatchedRNG::generateGamma(double* out, std::size_t n, double shape, double scale)
+{
+    source->generateGamma(out, n, shape, scale);
+}
+
+void MomentMatchedRNG::generateInverseGaussian(double* out, std::size_t n, double mean, double shape)
+{
+    source->generateInverseGaussian(out, n, mean, shape);
+}
+
+void MomentMatchedRNG::generatePoisson(double* out, std::size_t n, double mean)
+{
+    source->generatePoisson(out, n, mean);
 }
\ No newline at end of file
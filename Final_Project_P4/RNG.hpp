@@ -10,6 +10,33 @@
  * pseudorandom number generator known for its high-quality random numbers and long period.
  * This class is particularly useful in simulations, Monte Carlo methods, and other applications requiring
  * high-quality random numbers.
+ * The PipelinedRNG class wraps another RNG and runs it on a dedicated producer thread, passing blocks of numbers
+ * to the simulation thread through a lock-free single-producer/single-consumer ring. The producer starts with the
+ * first number drawn, and every stream of a pipelined generator is pipelined again, so each chunk of a parallel run
+ * has its own producer feeding the worker that steps it.
+ * Every generator can also fill blocks with gamma and inverse Gaussian samples built from its normals; these are the
+ * subordinators of the Variance Gamma and Normal Inverse Gaussian models.
+ * The ReplayRNG class records the numbers it draws from a source and serves the recording again after rewind(), so
+ * that several simulations can share common random numbers (the nested inner simulations of the Bermudan upper
+ * bound). A simulation that reads past the end of the recording extends it from the source, so the numbers never
+ * wrap around, however many a simulation needs.
+ * generateStep() draws one cross-section: one normal for each of n paths at a single time step. Only PathGenerator
+ * and the single-factor exact transitions it drives call it; every other caller draws with generateBlock(), whose
+ * numbers may be laid out along a path's time axis, across several factors or across whole simulations.
+ * The MomentMatchedRNG class wraps another RNG and shifts and rescales every cross-section it hands out so that it has
+ * exactly zero mean and unit variance, which removes most of the variance of payoffs that are smooth in the terminal
+ * price. Paths of a block are then no longer independent; the solver's standard errors treat each block as one
+ * batch. Its generateBlock() passes the source's numbers through unchanged, so engines that need independent
+ * normals (pathwise Greeks, Malliavin weights, the Bermudan inner simulations, models that simulate whole paths)
+ * are unaffected by the wrapper.
+ * The streams of a splittable generator depend on its seed, their index and an epoch. stream(index) uses the current
+ * epoch; a solver that must draw new paths each time it runs claims an epoch of its own with nextEpoch() when it
+ * starts and passes it to stream(index, epoch), so solves running at the same time on one generator never share
+ * paths. A stream is seeded with the whole (seed, index, epoch) sequence and its key() spells that sequence out, so
+ * distinct streams neither collide on a 32-bit seed nor share a cache key. PipelinedRNG and MomentMatchedRNG split
+ * by wrapping the streams of their source.
+ * A generator that can describe the sequence it draws from its seed reports it through key(); the shared path cache
+ * uses it, for freshly created streams only, to recognise path chunks simulated by other processes.
  */
 
 #ifndef RNG_HPP
@@ -17,23 +44,121 @@
 
 #include <memory>
 #include <random>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include "SPSCRing.hpp"
 
 class RNG
 {
 public:
     virtual ~RNG() = default;
     virtual double generate() = 0; // Generate a random number
+    virtual void generateBlock(double* out, std::size_t n); // Fill out[0..n) with random numbers
+    virtual void generateStep(double* out, std::size_t n); // Fill out[0..n) with one normal per path for one time step
+    virtual std::shared_ptr<RNG> stream(std::uint64_t index, std::uint64_t epoch) const; // Independent generator for parallel chunk index of epoch (nullptr if not splittable)
+    std::shared_ptr<RNG> stream(std::uint64_t index) const; // Generator for chunk index of the current epoch
+    virtual std::uint64_t epoch() const; // Epoch used by stream(index)
+    virtual std::uint64_t nextEpoch(); // Claim the current epoch for one caller and move the others to the next one
+    virtual std::string key() const; // Exact description of the sequence drawn after seeding (empty if unknown)
+    virtual void generateGamma(double* out, std::size_t n, double shape, double scale); // Fill out[0..n) with Gamma(shape, scale) samples
+    virtual void generateInverseGaussian(double* out, std::size_t n, double mean, double shape); // Fill out[0..n) with IG(mean, shape) samples
+    virtual void generatePoisson(double* out, std::size_t n, double mean); // Fill out[0..n) with Poisson(mean) counts
 };
 
 class MersenneTwister : public RNG
 {
 private:
+    std::vector<unsigned int> lineage; // Seed, then the index and epoch words of every split that led to this generator
+    std::atomic<std::uint64_t> current{ 0 }; // Epoch of stream(index), advanced by nextEpoch()
     std::mt19937 generator; // Mersenne Twister random number generator
     std::normal_distribution<double> distribution; // Normal distribution with mean 0.0 and standard deviation 1.0
 
+    explicit MersenneTwister(std::vector<unsigned int> lineage); // Stream constructor, seeded with the whole lineage
+
 public:
     MersenneTwister(unsigned int seed = std::random_device{}()); // Constructor with optional seed
     double generate() override; // Generate a random number from the normal distribution
+    void generateBlock(double* out, std::size_t n) override; // Fill a block without a virtual call per number
+    using RNG::stream;
+    std::shared_ptr<RNG> stream(std::uint64_t index, std::uint64_t epoch) const override; // Generator seeded from (lineage, index, epoch)
+    std::uint64_t epoch() const override; // Epoch of stream(index)
+    std::uint64_t nextEpoch() override; // Claim the current epoch
+    std::string key() const override; // Generator name and lineage
+};
+
+class PipelinedRNG : public RNG
+{
+private:
+    std::shared_ptr<RNG> source; // Generator run on the producer thread (not touched by the consumer)
+    std::size_t slotSize; // Numbers per slot
+    std::size_t slots; // Slots in the ring
+    SPSCRing<std::vector<double>> ring; // Filled blocks of numbers waiting to be consumed
+    std::vector<double>* current; // Slot currently being consumed (nullptr if none)
+    std::size_t position; // Read position inside the current slot
+    std::atomic<bool> stop; // Set by the destructor to shut the producer down
+    std::thread producer; // Dedicated producer thread (started by the first draw)
+
+    void produce(); // Producer loop: fill free slots until stopped
+    void nextSlot(); // Consumer: release the current slot and wait for the next one
+
+public:
+    static constexpr std::size_t defaultSlotSize = 16384; // Numbers per slot
+    static constexpr std::size_t defaultSlots = 8; // Slots in the ring
+
+    PipelinedRNG(std::shared_ptr<RNG> source, std::size_t slotSize = defaultSlotSize, std::size_t slots = defaultSlots); // Constructor
+    ~PipelinedRNG() override; // Stops and joins the producer
+    PipelinedRNG(const PipelinedRNG&) = delete;
+    PipelinedRNG& operator=(const PipelinedRNG&) = delete;
+
+    double generate() override; // Take one number from the ring
+    void generateBlock(double* out, std::size_t n) override; // Copy n numbers out of the ring
+    using RNG::stream;
+    std::shared_ptr<RNG> stream(std::uint64_t index, std::uint64_t epoch) const override; // Pipelined wrapper of the source's stream (nullptr if not splittable)
+    std::uint64_t epoch() const override; // The source's epoch
+    std::uint64_t nextEpoch() override; // Claim an epoch of the source
+    std::string key() const override; // The source's key: the ring hands out the source's numbers in order
+};
+
+class ReplayRNG : public RNG
+{
+private:
+    std::vector<double> buffer; // Recorded numbers
+    std::size_t position; // Next number to serve
+    RNG* source; // Generator that extends the recording (not owned; nullptr before the first refill)
+
+    void extend(std::size_t end); // Record numbers from source until the recording holds end numbers
+
+public:
+    explicit ReplayRNG(std::size_t reserve = 0); // Constructor, room for reserve numbers before the recording reallocates
+    void refill(RNG& source); // Discard the recording and start a new one drawn from source
+    void rewind(); // Serve the recording again from its start
+    double generate() override; // Next recorded number (drawn from the source past the end of the recording)
+    void generateBlock(double* out, std::size_t n) override; // Copy the next n recorded numbers, extending the recording if needed
+};
+
+class MomentMatchedRNG : public RNG
+{
+private:
+    std::shared_ptr<RNG> source; // Generator of the raw normals
+
+public:
+    explicit MomentMatchedRNG(std::shared_ptr<RNG> source); // Constructor
+    double generate() override; // One raw normal (a single number cannot be matched)
+    void generateBlock(double* out, std::size_t n) override; // n raw normals from the source
+    void generateStep(double* out, std::size_t n) override; // n normals with exactly zero mean and unit variance (n >= 2)
+    using RNG::stream;
+    std::shared_ptr<RNG> stream(std::uint64_t index, std::uint64_t epoch) const override; // Matched wrapper of the source's stream (nullptr if not splittable)
+    std::uint64_t epoch() const override; // The source's epoch
+    std::uint64_t nextEpoch() override; // Claim an epoch of the source
+    std::string key() const override; // The source's key, marked as matched
+    // Subordinator samples come from the source: matching the normals they are built from would distort their laws
+    void generateGamma(double* out, std::size_t n, double shape, double scale) override;
+    void generateInverseGaussian(double* out, std::size_t n, double mean, double shape) override;
+    void generatePoisson(double* out, std::size_t n, double mean) override;
 };
 
 #endif // RNG_HPP
\ No newline at end of file
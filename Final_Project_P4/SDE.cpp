@@ -8,42 +8,842 @@
  * for the GBM, CEV, and CIR models, which are widely used in financial modeling. Each class computes the drift
  * and diffusion terms of the corresponding stochastic differential equation, which are essential for simulating
  * stochastic processes such as asset prices and interest rates.
+ * RoughBergomi simulates the Volterra process with the hybrid scheme of Bennedsen, Lunde and Pakkanen (kappa = 1):
+ * the most recent step is sampled exactly and the rest of the kernel integral is a Riemann sum at optimal points.
+ * That sum is a convolution, computed per pair of paths with one complex FFT (one path in the real part, the other
+ * in the imaginary part), which costs O(N log N) per path instead of O(N^2).
+ * The models that fill whole blocks step log S, so they also record each path's sum of log S in the block.
  */
 
 #include "SDE.hpp"
+#include "PathBlock.hpp"
+#include "Dispatch.hpp"
+#include "RNG.hpp"
+#include "FFT.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <complex>
+#include <sstream>
+#include <vector>
+
+static std::string formatKey(const char* name, std::initializer_list<double> parameters)
+{
+    std::ostringstream out;
+    out << name << std::hexfloat; // Hexadecimal floats are exact, so equal keys mean equal parameters
+    for (double parameter : parameters)
+    {
+        out << ':' << parameter;
+    }
+    return out.str();
+}
+
+std::string SDE::key() const
+{
+    return ""; // Unknown models are only identified by their address
+}
+
+bool SDE::hasExactTransition() const
+{
+    return false; // Most models have to be discretised
+}
+
+bool SDE::batchModel(BatchModel& model, double* parameters) const
+{
+    return false; // General models are stepped one path at a time
+}
+
+void SDE::transitionBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* Z)
+{
+    throw std::logic_error("This SDE has no exact transition law.");
+}
+
+void SDE::sampleTransition(const double* S, double* out, std::size_t n, double t, double dt, RNG& rng, double* Z)
+{
+    rng.generateStep(Z, n); // Diffusions need one normal per path
+    transitionBlock(S, out, n, t, dt, Z);
+}
+
+void SDE::calibrate(double S0, double T, int N, std::shared_ptr<RNG> rng)
+{
+    // Most models have no state that depends on the simulation grid
+}
+
+bool SDE::simulatesPaths() const
+{
+    return false; // Markovian models are stepped by an FDM scheme
+}
+
+void SDE::simulateBlock(PathBlock& block, RNG& rng)
+{
+    throw std::logic_error("This SDE does not simulate path blocks itself.");
+}
+
+bool SDE::hasCharacteristicFunction() const
+{
+    return false; // Most models have no closed-form characteristic function
+}
+
+std::complex<double> SDE::characteristicFunction(std::complex<double> u, double T) const
+{
+    throw std::logic_error("This SDE has no closed-form characteristic function.");
+}
+
+void SDE::setBoundary(Boundary boundary)
+{
+    policy = boundary;
+}
+
+Boundary SDE::boundary() const
+{
+    return policy;
+}
+
+std::size_t SDE::applyBoundary(const double* previous, double* next, std::size_t n, std::uint8_t* rejected) const
+{
+    const KernelTable& kernel = kernels(); // Resolved once per row; each kernel is a compare and a select across paths
+    switch (policy)
+    {
+    case Boundary::Absorb:
+        return kernel.absorb(previous, next, n);
+    case Boundary::Reflect:
+        return kernel.reflect(next, n);
+    case Boundary::Reject:
+        return rejected ? kernel.reject(next, rejected, n) : kernel.truncate(next, n); // Without flags a rejection only truncates
+    default:
+        return kernel.truncate(next, n);
+    }
+}
+
+void SDE::countBoundary(std::uint64_t fired, std::uint64_t rejected) const
+{
+    hits.fetch_add(fired, std::memory_order_relaxed);
+    rejections.fetch_add(rejected, std::memory_order_relaxed);
+}
+
+std::uint64_t SDE::boundaryHits() const
+{
+    return hits.load(std::memory_order_relaxed);
+}
+
+std::uint64_t SDE::rejectedPaths() const
+{
+    return rejections.load(std::memory_order_relaxed);
+}
+
+void SDE::resetBoundaryCounters()
+{
+    hits = 0;
+    rejections = 0;
+}
 
 GBM::GBM(double mu, double sigma) : mu(mu), sigma(sigma) {}
 
 double GBM::drift(double S, double t)
 {
-    return mu * S; // Drift term for Geometric Brownian Motion: mu * S
+    return Kernel<double>{ mu, sigma }.drift(S, t); // Drift term for Geometric Brownian Motion: mu * S
 }
 
 double GBM::diffusion(double S, double t)
 {
-    return sigma * S; // Diffusion term for Geometric Brownian Motion: sigma * S
+    return Kernel<double>{ mu, sigma }.diffusion(S, t); // Diffusion term for Geometric Brownian Motion: sigma * S
+}
+
+std::array<double, 2> GBM::parameters() const
+{
+    return { mu, sigma };
+}
+
+std::string GBM::key() const
+{
+    return formatKey("GBM", { mu, sigma });
+}
+
+bool GBM::hasExactTransition() const
+{
+    return true;
+}
+
+bool GBM::batchModel(BatchModel& model, double* parameters) const
+{
+    model = BatchModel::GBM;
+    parameters[0] = mu;
+    parameters[1] = sigma;
+    return true;
+}
+
+void GBM::transitionBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* Z)
+{
+    double drift = (mu - 0.5 * sigma * sigma) * dt; // Log-drift over the interval
+    double vol = sigma * std::sqrt(dt); // Log-volatility over the interval
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        out[i] = S[i] * std::exp(drift + vol * Z[i]); // Exact lognormal step, valid for any dt
+    }
+}
+
+bool GBM::hasCharacteristicFunction() const
+{
+    return true;
+}
+
+std::complex<double> GBM::characteristicFunction(std::complex<double> u, double T) const
+{
+    const std::complex<double> i(0.0, 1.0);
+    return std::exp(i * u * (mu - 0.5 * sigma * sigma) * T - 0.5 * sigma * sigma * u * u * T);
 }
 
 CEV::CEV(double mu, double sigma, double gamma) : mu(mu), sigma(sigma), gamma(gamma) {}
 
 double CEV::drift(double S, double t)
 {
-    return mu * S; // Drift term for Constant Elasticity of Variance model: mu * S
+    return Kernel<double>{ mu, sigma, gamma }.drift(S, t); // Drift term for Constant Elasticity of Variance model: mu * S
 }
 
 double CEV::diffusion(double S, double t)
 {
-    return sigma * std::pow(S, gamma); // Diffusion term for CEV model: sigma * S^gamma
+    return Kernel<double>{ mu, sigma, gamma }.diffusion(S, t); // Diffusion term for CEV model: sigma * S^gamma
 }
 
-CIR::CIR(double kappa, double theta, double sigma) : kappa(kappa), theta(theta), sigma(sigma) {}
+std::array<double, 3> CEV::parameters() const
+{
+    return { mu, sigma, gamma };
+}
+
+std::string CEV::key() const
+{
+    return formatKey("CEV", { mu, sigma, gamma });
+}
+
+bool CEV::batchModel(BatchModel& model, double* parameters) const
+{
+    model = BatchModel::CEV;
+    parameters[0] = mu;
+    parameters[1] = sigma;
+    parameters[2] = gamma;
+    return true;
+}
+
+CIR::CIR(double kappa, double theta, double sigma) : kappa(kappa), theta(theta), sigma(sigma)
+{
+    setBoundary(Boundary::Truncate); // Zero is not absorbing for CIR: the drift kappa * theta pushes it back up
+}
 
 double CIR::drift(double S, double t)
 {
-    return kappa * (theta - S); // Drift term for Cox-Ingersoll-Ross model: kappa * (theta - S)
+    return Kernel<double>{ kappa, theta, sigma }.drift(S, t); // Drift term for Cox-Ingersoll-Ross model: kappa * (theta - S)
 }
 
 double CIR::diffusion(double S, double t)
 {
-    return sigma * std::sqrt(S); // Diffusion term for CIR model: sigma * sqrt(S)
+    return Kernel<double>{ kappa, theta, sigma }.diffusion(S, t); // Diffusion term for CIR model: sigma * sqrt(S)
+}
+
+std::array<double, 3> CIR::parameters() const
+{
+    return { kappa, theta, sigma };
+}
+
+std::string CIR::key() const
+{
+    return formatKey("CIR", { kappa, theta, sigma });
+}
+
+bool CIR::batchModel(BatchModel& model, double* parameters) const
+{
+    model = BatchModel::CIR;
+    parameters[0] = kappa;
+    parameters[1] = theta;
+    parameters[2] = sigma;
+    return true;
+}
+
+RoughBergomi::RoughBergomi(double r, double xi, double eta, double H, double rho) : r(r), xi(xi), eta(eta), H(H), rho(rho)
+{
+    if (xi <= 0 || eta < 0 || H <= 0 || H >= 0.5 || rho < -1 || rho > 1)
+    {
+        throw std::invalid_argument("Rough Bergomi needs xi > 0, eta >= 0, 0 < H < 1/2 and -1 <= rho <= 1.");
+    }
+}
+
+double RoughBergomi::drift(double S, double t)
+{
+    return r * S; // Drift term: r * S
+}
+
+double RoughBergomi::diffusion(double S, double t)
+{
+    throw std::logic_error("Rough Bergomi volatility depends on the whole path; it is simulated by simulateBlock, not an FDM.");
+}
+
+std::string RoughBergomi::key() const
+{
+    return formatKey("RoughBergomi", { r, xi, eta, H, rho });
+}
+
+bool RoughBergomi::simulatesPaths() const
+{
+    return true;
+}
+
+void RoughBergomi::simulateBlock(PathBlock& block, RNG& rng)
+{
+    std::size_t n = block.size();
+    std::size_t N = block.numSteps();
+    const std::vector<double>& t = block.times();
+    double dt = t[N] / N; // The hybrid scheme needs a uniform grid
+    if (std::abs(t[1] - dt) > 1e-9 * t[N])
+    {
+        throw std::invalid_argument("Rough Bergomi requires a uniform time grid.");
+    }
+
+    double a = H - 0.5; // Kernel exponent alpha
+    double l11 = std::sqrt(dt); // Cholesky factor of the covariance of (dW, dW1) over one step
+    double l21 = std::pow(dt, a + 1) / (a + 1) / l11;
+    double l22 = std::sqrt(std::pow(dt, 2 * a + 1) / (2 * a + 1) - l21 * l21);
+    double scale = std::sqrt(2 * a + 1); // Normalisation sqrt(2H) of the Volterra process
+    double perp = std::sqrt(1 - rho * rho);
+
+    FFT fft(FFT::nextPowerOfTwo(2 * N)); // Long enough for a linear convolution of two length-N sequences
+    std::size_t L = fft.size();
+    std::vector<std::complex<double>> kernel(L, 0.0); // Riemann-sum weights g(b_k * dt) for k >= 2
+    for (std::size_t k = 2; k <= N; ++k)
+    {
+        double b = std::pow((std::pow(double(k), a + 1) - std::pow(double(k - 1), a + 1)) / (a + 1), 1 / a); // Optimal evaluation point
+        kernel[k] = std::pow(b * dt, a);
+    }
+    fft.forward(kernel.data());
+
+    std::vector<double> variance(N); // Forward variance compensator 0.5 * eta^2 * t^(2H)
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        variance[i] = 0.5 * eta * eta * std::pow(t[i], 2 * a + 1);
+    }
+
+    std::vector<double> z(6 * N); // Three normals per step for each of the two paths of a pair
+    std::vector<std::complex<double>> conv(L); // Both paths of the pair packed into one complex sequence
+    for (std::size_t p = 0; p < n; p += 2)
+    {
+        std::size_t pair = std::min<std::size_t>(2, n - p);
+        rng.generateBlock(z.data(), 3 * N * pair);
+
+        const double* z0 = &z[0]; // Normals of the first path
+        const double* z1 = &z[3 * N]; // Normals of the second path (unused if the block has an odd path left)
+        std::fill(conv.begin(), conv.end(), 0.0);
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            conv[i] = std::complex<double>(l11 * z0[i], pair > 1 ? l11 * z1[i] : 0.0); // Brownian increments driving the variance
+        }
+        fft.forward(conv.data());
+        for (std::size_t k = 0; k < L; ++k)
+        {
+            conv[k] *= kernel[k]; // Real kernel: the two packed paths stay separated
+        }
+        fft.inverse(conv.data());
+
+        for (std::size_t q = 0; q < pair; ++q)
+        {
+            const double* zq = &z[3 * N * q];
+            double S = block.row(0)[p + q];
+            double x = std::log(S); // Log price, accumulated into the block's log sums
+            double logSum = x;
+            double Y = 0.0; // Volterra process at t_i (zero at t_0)
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                double V = xi * std::exp(eta * Y - variance[i]); // Spot variance at t_i
+                double dW = l11 * zq[i];
+                double dB = rho * dW + perp * l11 * zq[2 * N + i]; // Correlated Brownian increment of the asset
+                double dx = r * dt + std::sqrt(V) * dB - 0.5 * V * dt;
+                S *= std::exp(dx); // Log-Euler step
+                block.row(i + 1)[p + q] = S;
+                x += dx;
+                logSum += x;
+
+                double exact = l21 * zq[i] + l22 * zq[N + i]; // dW1: exact kernel integral over the last step
+                double riemann = q == 0 ? conv[i + 1].real() : conv[i + 1].imag(); // Kernel sum over earlier steps
+                Y = scale * (exact + riemann);
+            }
+            block.logSums()[p + q] = logSum;
+        }
+    }
+    block.setLogSums(true);
+}
+
+LevyProcess::LevyProcess(double r) : r(r) {}
+
+double LevyProcess::drift(double S, double t)
+{
+    return r * S; // Drift term: r * S
+}
+
+double LevyProcess::diffusion(double S, double t)
+{
+    throw std::logic_error("Levy models move by jumps; they are simulated by exact subordination, not an FDM.");
+}
+
+bool LevyProcess::hasExactTransition() const
+{
+    return true;
+}
+
+void LevyProcess::sampleTransition(const double* S, double* out, std::size_t n, double t, double dt, RNG& rng, double* Z)
+{
+    increments(out, n, dt, rng); // Log-returns of the jump part
+    double drift = (r + compensator()) * dt; // Keeps the discounted price a martingale
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        out[i] = S[i] * std::exp(drift + out[i]);
+    }
+}
+
+bool LevyProcess::simulatesPaths() const
+{
+    return true;
+}
+
+void LevyProcess::simulateBlock(PathBlock& block, RNG& rng)
+{
+    std::size_t n = block.size();
+    const std::vector<double>& t = block.times();
+    std::vector<double> X(n), x(n); // Log-returns of one step, running log prices
+    double* logSums = block.logSums();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        x[i] = logSums[i] = std::log(block.row(0)[i]);
+    }
+    for (std::size_t j = 0; j < block.numSteps(); ++j)
+    {
+        double dt = t[j + 1] - t[j];
+        increments(X.data(), n, dt, rng); // Same draws and prices as sampleTransition(), exact for any step size
+        double drift = (r + compensator()) * dt;
+        const double* S = block.row(j);
+        double* out = block.row(j + 1);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double dx = drift + X[i];
+            out[i] = S[i] * std::exp(dx);
+            x[i] += dx;
+            logSums[i] += x[i];
+        }
+    }
+    block.setLogSums(true);
+}
+
+bool LevyProcess::hasCharacteristicFunction() const
+{
+    return true;
+}
+
+std::complex<double> LevyProcess::characteristicFunction(std::complex<double> u, double T) const
+{
+    const std::complex<double> i(0.0, 1.0);
+    return std::exp(i * u * (r + compensator()) * T + T * exponent(u)); // Same drift as sampleTransition()
+}
+
+VarianceGamma::VarianceGamma(double r, double sigma, double nu, double theta) : LevyProcess(r), sigma(sigma), nu(nu), theta(theta)
+{
+    if (sigma <= 0 || nu <= 0 || 1 - theta * nu - 0.5 * sigma * sigma * nu <= 0)
+    {
+        throw std::invalid_argument("Variance Gamma needs sigma > 0, nu > 0 and theta nu + sigma^2 nu / 2 < 1.");
+    }
+}
+
+double VarianceGamma::compensator() const
+{
+    return std::log(1 - theta * nu - 0.5 * sigma * sigma * nu) / nu;
+}
+
+void VarianceGamma::increments(double* X, std::size_t n, double dt, RNG& rng) const
+{
+    std::vector<double> Z(n);
+    rng.generateGamma(X, n, dt / nu, nu); // Gamma clock with mean dt and variance nu dt
+    rng.generateBlock(Z.data(), n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        X[i] = theta * X[i] + sigma * std::sqrt(X[i]) * Z[i]; // Brownian motion with drift run on the gamma clock
+    }
+}
+
+std::complex<double> VarianceGamma::exponent(std::complex<double> u) const
+{
+    const std::complex<double> i(0.0, 1.0);
+    return -std::log(1.0 - i * u * theta * nu + 0.5 * sigma * sigma * nu * u * u) / nu;
+}
+
+std::string VarianceGamma::key() const
+{
+    return formatKey("VarianceGamma", { r, sigma, nu, theta });
+}
+
+NormalInverseGaussian::NormalInverseGaussian(double r, double alpha, double beta, double delta)
+    : LevyProcess(r), alpha(alpha), beta(beta), delta(delta)
+{
+    if (delta <= 0 || alpha <= std::abs(beta) || alpha <= std::abs(beta + 1))
+    {
+        throw std::invalid_argument("Normal Inverse Gaussian needs delta > 0, |beta| < alpha and |beta + 1| < alpha.");
+    }
+}
+
+double NormalInverseGaussian::compensator() const
+{
+    return delta * (std::sqrt(alpha * alpha - (beta + 1) * (beta + 1)) - std::sqrt(alpha * alpha - beta * beta));
+}
+
+void NormalInverseGaussian::increments(double* X, std::size_t n, double dt, RNG& rng) const
+{
+    double gamma = std::sqrt(alpha * alpha - beta * beta);
+    std::vector<double> Z(n);
+    rng.generateInverseGaussian(X, n, delta * dt / gamma, delta * delta * dt * dt); // Inverse Gaussian clock
+    rng.generateBlock(Z.data(), n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        X[i] = beta * X[i] + std::sqrt(X[i]) * Z[i]; // Brownian motion with drift beta run on the inverse Gaussian clock
+    }
+}
+
+std::complex<double> NormalInverseGaussian::exponent(std::complex<double> u) const
+{
+    const std::complex<double> i(0.0, 1.0);
+    return delta * (std::sqrt(alpha * alpha - beta * beta) - std::sqrt(alpha * alpha - (beta + i * u) * (beta + i * u)));
+}
+
+std::string NormalInverseGaussian::key() const
+{
+    return formatKey("NormalInverseGaussian", { r, alpha, beta, delta });
+}
+
+MertonJumpDiffusion::MertonJumpDiffusion(double r, double sigma, double lambda, double muJ, double deltaJ)
+    : LevyProcess(r), sigma(sigma), lambda(lambda), muJ(muJ), deltaJ(deltaJ)
+{
+    if (sigma < 0 || lambda < 0 || deltaJ < 0)
+    {
+        throw std::invalid_argument("Merton's jump diffusion needs sigma >= 0, lambda >= 0 and deltaJ >= 0.");
+    }
+}
+
+double MertonJumpDiffusion::compensator() const
+{
+    return -0.5 * sigma * sigma - lambda * (std::exp(muJ + 0.5 * deltaJ * deltaJ) - 1);
+}
+
+void MertonJumpDiffusion::increments(double* X, std::size_t n, double dt, RNG& rng) const
+{
+    std::vector<double> Z(2 * n);
+    rng.generatePoisson(X, n, lambda * dt); // Number of jumps in the step
+    rng.generateBlock(Z.data(), 2 * n);
+    double vol = sigma * std::sqrt(dt);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        double k = X[i];
+        X[i] = vol * Z[i] + k * muJ + std::sqrt(k) * deltaJ * Z[n + i]; // Given k jumps, their sum is normal
+    }
+}
+
+std::complex<double> MertonJumpDiffusion::exponent(std::complex<double> u) const
+{
+    const std::complex<double> i(0.0, 1.0);
+    return -0.5 * sigma * sigma * u * u + lambda * (std::exp(i * u * muJ - 0.5 * deltaJ * deltaJ * u * u) - 1.0);
+}
+
+std::string MertonJumpDiffusion::key() const
+{
+    return formatKey("MertonJumpDiffusion", { r, sigma, lambda, muJ, deltaJ });
+}
+
+Heston::Heston(double r, double kappa, double theta, double xi, double rho, double v0)
+    : r(r), kappa(kappa), theta(theta), xi(xi), rho(rho), v0(v0)
+{
+    if (kappa < 0 || theta <= 0 || xi <= 0 || rho < -1 || rho > 1 || v0 <= 0)
+    {
+        throw std::invalid_argument("Heston needs kappa >= 0, theta > 0, xi > 0, -1 <= rho <= 1 and v0 > 0.");
+    }
+}
+
+double Heston::drift(double S, double t)
+{
+    return r * S; // Drift term: r * S
+}
+
+double Heston::diffusion(double S, double t)
+{
+    throw std::logic_error("Heston depends on the variance path; it is simulated by simulateBlock, not an FDM.");
+}
+
+std::string Heston::key() const
+{
+    return formatKey("Heston", { r, kappa, theta, xi, rho, v0 });
+}
+
+bool Heston::simulatesPaths() const
+{
+    return true;
+}
+
+void Heston::simulateBlock(PathBlock& block, RNG& rng)
+{
+    std::size_t n = block.size();
+    const std::vector<double>& t = block.times();
+    double orthogonal = std::sqrt(1 - rho * rho);
+    std::vector<double> x(n), v(n, v0), Z(2 * n);
+    double* logSums = block.logSums();
+    for (std::size_t p = 0; p < n; ++p)
+    {
+        x[p] = logSums[p] = std::log(block.row(0)[p]);
+    }
+    for (std::size_t j = 0; j < block.numSteps(); ++j)
+    {
+        double dt = t[j + 1] - t[j];
+        double sqrtDt = std::sqrt(dt);
+        rng.generateBlock(Z.data(), 2 * n);
+        double* next = block.row(j + 1);
+        for (std::size_t p = 0; p < n; ++p)
+        {
+            double vp = std::max(v[p], 0.0); // Full truncation keeps the variance usable when it dips below zero
+            double z2 = rho * Z[p] + orthogonal * Z[n + p];
+            x[p] += (r - 0.5 * vp) * dt + std::sqrt(vp) * sqrtDt * Z[p];
+            v[p] += kappa * (theta - vp) * dt + xi * std::sqrt(vp) * sqrtDt * z2;
+            next[p] = std::exp(x[p]);
+            logSums[p] += x[p];
+        }
+    }
+    block.setLogSums(true);
+}
+
+bool Heston::hasCharacteristicFunction() const
+{
+    return true;
+}
+
+std::complex<double> Heston::characteristicFunction(std::complex<double> u, double T) const
+{
+    const std::complex<double> i(0.0, 1.0);
+    std::complex<double> beta = kappa - rho * xi * i * u;
+    std::complex<double> d = std::sqrt(beta * beta + xi * xi * (i * u + u * u));
+    std::complex<double> g = (beta - d) / (beta + d); // Root with |g| < 1: no branch cut of the logarithm is crossed
+    std::complex<double> e = std::exp(-d * T);
+    std::complex<double> C = i * u * r * T + kappa * theta / (xi * xi) * ((beta - d) * T - 2.0 * std::log((1.0 - g * e) / (1.0 - g)));
+    std::complex<double> D = (beta - d) / (xi * xi) * (1.0 - e) / (1.0 - g * e);
+    return std::exp(C + D * v0);
+}
+
+StochasticLocalVol::StochasticLocalVol(double r, double kappa, double theta, double xi, double rho, double v0,
+    std::function<double(double, double)> localVol, std::size_t particles, std::size_t bins)
+    : r(r), kappa(kappa), theta(theta), xi(xi), rho(rho), v0(v0), localVol(localVol), particles(particles), bins(bins)
+{
+    if (kappa < 0 || theta <= 0 || xi < 0 || rho < -1 || rho > 1 || v0 <= 0)
+    {
+        throw std::invalid_argument("Stochastic local volatility needs kappa >= 0, theta > 0, xi >= 0, -1 <= rho <= 1 and v0 > 0.");
+    }
+    if (!localVol || particles == 0 || bins < 2)
+    {
+        throw std::invalid_argument("Stochastic local volatility needs a local volatility function, particles and at least two bins.");
+    }
+}
+
+double StochasticLocalVol::drift(double S, double t)
+{
+    return r * S; // Drift term: r * S
+}
+
+double StochasticLocalVol::diffusion(double S, double t)
+{
+    throw std::logic_error("Stochastic local volatility depends on the variance path; it is simulated by simulateBlock, not an FDM.");
+}
+
+bool StochasticLocalVol::simulatesPaths() const
+{
+    return true;
+}
+
+double StochasticLocalVol::Leverage::at(std::size_t j, double x) const
+{
+    double u = (x - lo[j]) / width[j] - 0.5; // Position relative to the bin centres
+    double b = std::clamp(std::floor(u), 0.0, static_cast<double>(bins - 2));
+    double w = std::clamp(u - b, 0.0, 1.0); // Flat beyond the outer centres
+    const double* L = values.data() + j * bins + static_cast<std::size_t>(b);
+    return L[0] + w * (L[1] - L[0]);
+}
+
+void StochasticLocalVol::advance(double* x, double* v, std::size_t n, const Leverage& leverage, std::size_t j, double dt, const double* Z) const
+{
+    double sqrtDt = std::sqrt(dt);
+    double orthogonal = std::sqrt(1 - rho * rho);
+    for (std::size_t p = 0; p < n; ++p)
+    {
+        double vp = std::max(v[p], 0.0); // Full truncation keeps the variance usable when it dips below zero
+        double vol = leverage.at(j, x[p]) * std::sqrt(vp);
+        double z1 = Z[p];
+        double z2 = rho * z1 + orthogonal * Z[n + p];
+        x[p] += (r - 0.5 * vol * vol) * dt + vol * sqrtDt * z1;
+        v[p] += kappa * (theta - vp) * dt + xi * std::sqrt(vp) * sqrtDt * z2;
+    }
+}
+
+void StochasticLocalVol::simulateBlock(PathBlock& block, RNG& rng)
+{
+    std::size_t n = block.size();
+    std::size_t N = block.numSteps();
+    const std::vector<double>& t = block.times();
+
+    std::shared_ptr<const Leverage> leverage;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = calibrated.find({ block.row(0)[0], t[N], static_cast<int>(N) });
+        if (found == calibrated.end())
+        {
+            throw std::logic_error("Stochastic local volatility is not calibrated for this S0 and grid; call calibrate() first.");
+        }
+        leverage = found->second;
+    }
+
+    std::vector<double> x(n), v(n, v0), Z(2 * n);
+    double* logSums = block.logSums();
+    for (std::size_t p = 0; p < n; ++p)
+    {
+        x[p] = logSums[p] = std::log(block.row(0)[p]);
+    }
+    for (std::size_t j = 0; j < N; ++j)
+    {
+        rng.generateBlock(Z.data(), 2 * n);
+        advance(x.data(), v.data(), n, *leverage, j, t[j + 1] - t[j], Z.data());
+        double* next = block.row(j + 1);
+        for (std::size_t p = 0; p < n; ++p)
+        {
+            next[p] = std::exp(x[p]);
+            logSums[p] += x[p];
+        }
+    }
+    block.setLogSums(true);
+}
+
+void StochasticLocalVol::calibrate(double S0, double T, int N, std::shared_ptr<RNG> rng)
+{
+    if (!rng || S0 <= 0 || T <= 0 || N <= 0)
+    {
+        throw std::invalid_argument("Calibration needs an RNG and positive S0, T and N.");
+    }
+    std::vector<double> grid(N + 1);
+    for (int j = 0; j <= N; ++j)
+    {
+        grid[j] = T * j / N; // Same grid as PathGenerator
+    }
+    std::tuple<double, double, int> key{ S0, grid[N], N };
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (calibrated.count(key))
+        {
+            return; // Already calibrated for this grid
+        }
+    }
+
+    auto leverage = std::make_shared<Leverage>();
+    leverage->bins = bins;
+    leverage->lo.assign(N, 0.0);
+    leverage->width.assign(N, 1.0);
+    leverage->values.assign(N * bins, localVol(S0, 0.0) / std::sqrt(v0)); // Every particle starts at S0 with variance v0
+    leverage->lo[0] = std::log(S0) - 0.5 * bins;
+
+    std::size_t slices = (particles + sliceSize - 1) / sliceSize;
+    std::vector<std::shared_ptr<RNG>> streams(slices);
+    bool parallel = rng->stream(0) != nullptr;
+    for (std::size_t s = 0; parallel && s < slices; ++s)
+    {
+        streams[s] = rng->stream(calibrationStream + s); // Each slice draws from its own stream
+    }
+    auto forEachSlice = [&](const std::function<void(std::size_t)>& body)
+    {
+        if (parallel)
+        {
+            ThreadPool::instance().parallelFor(slices, body);
+        }
+        else
+        {
+            for (std::size_t s = 0; s < slices; ++s)
+            {
+                body(s); // The RNG cannot be split: run the slices in order on this thread
+            }
+        }
+    };
+
+    std::vector<double> x(particles, std::log(S0)), v(particles, v0), Z(2 * particles);
+    std::vector<double> moments(2 * slices); // Sum and sum of squares of x per slice
+    std::vector<double> sums(slices * bins), counts(slices * bins); // Binned sum of v and particle count per slice
+    std::vector<double> conditional(bins);
+
+    for (int j = 0; j + 1 < N; ++j)
+    {
+        forEachSlice([&](std::size_t s)
+        {
+            std::size_t first = s * sliceSize;
+            std::size_t m = std::min(sliceSize, particles - first);
+            double* z = Z.data() + 2 * first;
+            (parallel ? *streams[s] : *rng).generateBlock(z, 2 * m);
+            advance(x.data() + first, v.data() + first, m, *leverage, j, grid[j + 1] - grid[j], z);
+            double sum = 0.0, squares = 0.0;
+            for (std::size_t p = first; p < first + m; ++p)
+            {
+                sum += x[p];
+                squares += x[p] * x[p];
+            }
+            moments[2 * s] = sum;
+            moments[2 * s + 1] = squares;
+        });
+
+        double sum = 0.0, squares = 0.0;
+        for (std::size_t s = 0; s < slices; ++s)
+        {
+            sum += moments[2 * s];
+            squares += moments[2 * s + 1];
+        }
+        double mean = sum / particles;
+        double spread = 4.0 * std::sqrt(std::max(squares / particles - mean * mean, 0.0)) + 1e-12; // Bins cover four standard deviations; the tails fall into the outer bins
+        double lo = mean - spread;
+        double width = 2.0 * spread / bins;
+
+        forEachSlice([&](std::size_t s)
+        {
+            std::size_t first = s * sliceSize;
+            std::size_t m = std::min(sliceSize, particles - first);
+            double* sum = sums.data() + s * bins;
+            double* count = counts.data() + s * bins;
+            std::fill(sum, sum + bins, 0.0);
+            std::fill(count, count + bins, 0.0);
+            for (std::size_t p = first; p < first + m; ++p)
+            {
+                std::size_t b = static_cast<std::size_t>(std::clamp((x[p] - lo) / width, 0.0, bins - 1.0));
+                sum[b] += std::max(v[p], 0.0);
+                count[b] += 1.0;
+            }
+        });
+
+        double overall = 0.0;
+        for (std::size_t b = 0; b < bins; ++b)
+        {
+            double total = 0.0, count = 0.0;
+            for (std::size_t s = 0; s < slices; ++s)
+            {
+                total += sums[s * bins + b]; // Combine in slice order so the result does not depend on scheduling
+                count += counts[s * bins + b];
+            }
+            sums[b] = total; // Slice 0 now holds the combined bins
+            counts[b] = count;
+            overall += total;
+        }
+        overall /= particles; // Unconditional E[v]
+        for (std::size_t b = 0; b < bins; ++b)
+        {
+            conditional[b] = (sums[b] + shrinkage * overall) / (counts[b] + shrinkage); // Sparse bins lean on E[v] instead of blowing up L
+        }
+
+        std::size_t next = j + 1;
+        leverage->lo[next] = lo;
+        leverage->width[next] = width;
+        for (std::size_t b = 0; b < bins; ++b)
+        {
+            double S = std::exp(lo + (b + 0.5) * width);
+            leverage->values[next * bins + b] = localVol(S, grid[next]) / std::sqrt(std::max(conditional[b], 1e-4 * theta));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    calibrated.emplace(key, leverage);
 }
\ No newline at end of file
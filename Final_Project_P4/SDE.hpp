@@ -8,6 +8,29 @@
  * The SDE class is an abstract base class providing an interface for the drift and diffusion terms of an SDE.
  * Three derived classes are implemented: GBM (Geometric Brownian Motion), CEV (Constant Elasticity of Variance), and CIR (Cox-Ingersoll-Ross).
  * These classes are commonly used in financial mathematics to model asset prices, interest rates, and other stochastic processes.
+ * Models whose transition law is known in closed form (GBM) can also sample S(t + dt) given S(t) exactly for any dt,
+ * which lets the engine jump straight between observation dates.
+ * Path-dependent (non-Markovian) models such as rough Bergomi cannot be written as drift(S, t) and diffusion(S, t);
+ * they simulate whole path blocks themselves through simulateBlock(), and the solver uses that instead of an FDM.
+ * Pure-jump Levy models (Variance Gamma, Normal Inverse Gaussian) derive from LevyProcess. Their log-returns are
+ * Brownian motions run on a random clock (gamma or inverse Gaussian subordinator), so both observation dates and
+ * full grids are sampled exactly, with no small-step approximation. Merton's jump diffusion derives from it too: its
+ * increments are a Brownian step plus a Poisson number of normal log-jumps, also exact over any interval.
+ * Heston simulates its own paths with a log-Euler step for S and a full-truncation Euler step for the variance.
+ * The StochasticLocalVol model multiplies Heston variance by a leverage function L(S, t). L is fitted by the
+ * particle method in calibrate(), which the solver calls before simulating, so that the model reprices the
+ * vanilla options of a target local volatility surface.
+ * GBM, CEV and CIR write their drift and diffusion once in a Kernel template over the scalar type. The virtual
+ * double versions use Kernel<double>, and the forward-mode Greeks engine uses Kernel<Dual<K>> with its parameters
+ * seeded as differentiation variables.
+ * Every SDE carries a Boundary policy for scheme steps that land below zero (absorb, reflect, truncate, or reject the
+ * path), applied to whole rows of paths by applyBoundary() with branch-free loops, and counters of how often it fired.
+ * Prices absorb at zero by default; CIR truncates, since its drift pushes it back up from zero.
+ * GBM, CEV and CIR also report themselves through batchModel(): their Kernel templates are instantiated over the SIMD
+ * vector types in every dispatched KernelTable, so the FDM schemes step whole rows at the full vector width instead of
+ * one virtual call per path. A new model gets the same by writing its Kernel template and adding a BatchModel entry.
+ * Models whose characteristic function of log(S(T) / S(0)) is known in closed form (GBM, Heston, the Levy models
+ * including Merton's jump diffusion) return it from characteristicFunction(), which drives the Fourier pricer.
  */
 
 #ifndef SDE_HPP
@@ -15,13 +38,61 @@
 
 #include <memory>
 #include <cmath>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <complex>
+#include <stdexcept>
+#include <functional>
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include "Dispatch.hpp"
+
+class PathBlock;
+class RNG;
+
+enum class Boundary // What happens when a scheme step lands below zero
+{
+    Absorb,   // The path stays at zero from then on
+    Reflect,  // The step is mirrored back above zero
+    Truncate, // The price is clamped to zero and keeps evolving from there
+    Reject    // Clamped to zero, but the path is counted and left out of the estimates
+};
 
 class SDE
 {
+private:
+    Boundary policy = Boundary::Absorb; // Boundary policy of the model
+    mutable std::atomic<std::uint64_t> hits{ 0 }; // Steps that landed below zero
+    mutable std::atomic<std::uint64_t> rejections{ 0 }; // Paths rejected by the Reject policy
+
 public:
     virtual ~SDE() = default;
     virtual double drift(double S, double t) = 0; // Drift term of the SDE
     virtual double diffusion(double S, double t) = 0; // Diffusion term of the SDE
+    virtual std::string key() const; // Exact description of the model and its parameters (empty if unknown)
+    virtual bool hasExactTransition() const; // True if sampleTransition() samples the exact law
+    virtual bool batchModel(BatchModel& model, double* parameters) const; // True if the batch step kernels cover the model (parameters: up to maxBatchParameters)
+    virtual void transitionBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* Z); // Sample S(t + dt) from S(t) with standard normals Z
+    virtual void sampleTransition(const double* S, double* out, std::size_t n, double t, double dt, RNG& rng, double* Z); // Draw what the law needs from rng (Z: scratch for n numbers) and sample S(t + dt)
+    virtual bool simulatesPaths() const; // True if the model fills path blocks itself
+    virtual void simulateBlock(PathBlock& block, RNG& rng); // Fill rows 1..N of a block whose row 0 holds S0
+    virtual void calibrate(double S0, double T, int N, std::shared_ptr<RNG> rng); // Fit grid-dependent state before simulateBlock() (default: nothing)
+    virtual bool hasCharacteristicFunction() const; // True if characteristicFunction() is known in closed form
+    virtual std::complex<double> characteristicFunction(std::complex<double> u, double T) const; // E[exp(i u log(S(T) / S(0)))]
+
+    void setBoundary(Boundary boundary); // Choose the boundary policy
+    Boundary boundary() const; // Current boundary policy
+    // Apply the policy to n paths stepped from previous to next, flagging rejected paths when rejected is not null; returns the steps that fired
+    std::size_t applyBoundary(const double* previous, double* next, std::size_t n, std::uint8_t* rejected = nullptr) const;
+    void countBoundary(std::uint64_t fired, std::uint64_t rejected) const; // Add to the counters (once per block, not per step)
+    std::uint64_t boundaryHits() const; // Steps that landed below zero since the last reset
+    std::uint64_t rejectedPaths() const; // Paths rejected since the last reset
+    void resetBoundaryCounters(); // Zero both counters
 };
 
 class GBM : public SDE
@@ -31,9 +102,26 @@ private:
     double sigma; // Volatility (standard deviation of returns)
 
 public:
+    template <typename Real>
+    struct Kernel // Drift and diffusion over any scalar type
+    {
+        Real mu;
+        Real sigma;
+        static Kernel from(const std::array<Real, 2>& p) { return { p[0], p[1] }; }
+        Real drift(const Real& S, double t) const { return mu * S; }
+        Real diffusion(const Real& S, double t) const { return sigma * S; }
+    };
+
     GBM(double mu, double sigma); // Constructor for Geometric Brownian Motion
+    std::array<double, 2> parameters() const; // mu, sigma
     double drift(double S, double t) override; // Compute the drift term
     double diffusion(double S, double t) override; // Compute the diffusion term
+    std::string key() const override; // Model name and exact parameters
+    bool hasExactTransition() const override; // GBM is lognormal
+    bool hasCharacteristicFunction() const override; // Gaussian log-returns
+    std::complex<double> characteristicFunction(std::complex<double> u, double T) const override; // exp(i u (mu - sigma^2/2) T - sigma^2 u^2 T / 2)
+    bool batchModel(BatchModel& model, double* parameters) const override; // mu, sigma
+    void transitionBlock(const double* S, double* out, std::size_t n, double t, double dt, const double* Z) override; // S * exp((mu - sigma^2/2) dt + sigma sqrt(dt) Z)
 };
 
 class CEV : public SDE
@@ -44,9 +132,23 @@ private:
     double gamma; // Elasticity parameter (controls the relationship between price and volatility)
 
 public:
+    template <typename Real>
+    struct Kernel // Drift and diffusion over any scalar type
+    {
+        Real mu;
+        Real sigma;
+        Real gamma;
+        static Kernel from(const std::array<Real, 3>& p) { return { p[0], p[1], p[2] }; }
+        Real drift(const Real& S, double t) const { return mu * S; }
+        Real diffusion(const Real& S, double t) const { using std::pow; return sigma * pow(S, gamma); }
+    };
+
     CEV(double mu, double sigma, double gamma); // Constructor for Constant Elasticity of Variance model
+    std::array<double, 3> parameters() const; // mu, sigma, gamma
     double drift(double S, double t) override; // Compute the drift term
     double diffusion(double S, double t) override; // Compute the diffusion term
+    std::string key() const override; // Model name and exact parameters
+    bool batchModel(BatchModel& model, double* parameters) const override; // mu, sigma, gamma
 };
 
 class CIR : public SDE
@@ -57,9 +159,176 @@ private:
     double sigma; // Volatility
 
 public:
+    template <typename Real>
+    struct Kernel // Drift and diffusion over any scalar type
+    {
+        Real kappa;
+        Real theta;
+        Real sigma;
+        static Kernel from(const std::array<Real, 3>& p) { return { p[0], p[1], p[2] }; }
+        Real drift(const Real& S, double t) const { return kappa * (theta - S); }
+        Real diffusion(const Real& S, double t) const { using std::sqrt; return sigma * sqrt(S); }
+    };
+
     CIR(double kappa, double theta, double sigma); // Constructor for Cox-Ingersoll-Ross model
+    std::array<double, 3> parameters() const; // kappa, theta, sigma
     double drift(double S, double t) override; // Compute the drift term
     double diffusion(double S, double t) override; // Compute the diffusion term
+    std::string key() const override; // Model name and exact parameters
+    bool batchModel(BatchModel& model, double* parameters) const override; // kappa, theta, sigma
+};
+
+class RoughBergomi : public SDE
+{
+private:
+    double r; // Risk-free rate (drift of the asset)
+    double xi; // Flat forward variance curve xi_0(t)
+    double eta; // Volatility of volatility
+    double H; // Hurst exponent of the variance process (0 < H < 1/2)
+    double rho; // Correlation between the asset and the variance driver
+
+public:
+    RoughBergomi(double r, double xi, double eta, double H, double rho); // Constructor for the rough Bergomi model
+    double drift(double S, double t) override; // Compute the drift term
+    double diffusion(double S, double t) override; // Not defined: the volatility depends on the whole path
+    std::string key() const override; // Model name and exact parameters
+    bool simulatesPaths() const override; // Paths come from the hybrid scheme
+    void simulateBlock(PathBlock& block, RNG& rng) override; // Hybrid scheme with the Volterra convolution done by FFT
+};
+
+class LevyProcess : public SDE
+{
+protected:
+    double r; // Risk-free rate
+
+    virtual double compensator() const = 0; // omega such that E[exp(omega t + X(t))] = 1
+    virtual void increments(double* X, std::size_t n, double dt, RNG& rng) const = 0; // Sample n increments X(t + dt) - X(t)
+    virtual std::complex<double> exponent(std::complex<double> u) const = 0; // Levy exponent: E[exp(i u X(t))] = exp(t exponent(u))
+
+public:
+    explicit LevyProcess(double r); // Constructor
+    double drift(double S, double t) override; // Compute the drift term
+    double diffusion(double S, double t) override; // Not defined: the process moves by jumps only
+    bool hasExactTransition() const override; // Increments are sampled exactly over any interval
+    void sampleTransition(const double* S, double* out, std::size_t n, double t, double dt, RNG& rng, double* Z) override; // S * exp((r + omega) dt + X)
+    bool simulatesPaths() const override; // Full grids are sampled with the same exact transitions
+    void simulateBlock(PathBlock& block, RNG& rng) override; // Exact transition between every pair of grid dates
+    bool hasCharacteristicFunction() const override; // Given by the Levy exponent
+    std::complex<double> characteristicFunction(std::complex<double> u, double T) const override; // exp(i u (r + omega) T + T exponent(u))
+};
+
+class VarianceGamma : public LevyProcess
+{
+private:
+    double sigma; // Volatility of the time-changed Brownian motion
+    double nu; // Variance rate of the gamma clock
+    double theta; // Drift of the time-changed Brownian motion (skew)
+
+protected:
+    double compensator() const override; // log(1 - theta nu - sigma^2 nu / 2) / nu
+    void increments(double* X, std::size_t n, double dt, RNG& rng) const override; // theta G + sigma sqrt(G) Z, G ~ Gamma(dt / nu, nu)
+    std::complex<double> exponent(std::complex<double> u) const override; // -log(1 - i u theta nu + sigma^2 nu u^2 / 2) / nu
+
+public:
+    VarianceGamma(double r, double sigma, double nu, double theta); // Constructor for the Variance Gamma model
+    std::string key() const override; // Model name and exact parameters
+};
+
+class NormalInverseGaussian : public LevyProcess
+{
+private:
+    double alpha; // Tail heaviness
+    double beta; // Skew (|beta + 1| < alpha for a finite forward)
+    double delta; // Scale
+
+protected:
+    double compensator() const override; // delta (sqrt(alpha^2 - (beta + 1)^2) - sqrt(alpha^2 - beta^2))
+    void increments(double* X, std::size_t n, double dt, RNG& rng) const override; // beta I + sqrt(I) Z, I ~ IG(delta dt / gamma, delta^2 dt^2)
+    std::complex<double> exponent(std::complex<double> u) const override; // delta (gamma - sqrt(alpha^2 - (beta + i u)^2))
+
+public:
+    NormalInverseGaussian(double r, double alpha, double beta, double delta); // Constructor for the Normal Inverse Gaussian model
+    std::string key() const override; // Model name and exact parameters
+};
+
+class MertonJumpDiffusion : public LevyProcess
+{
+private:
+    double sigma; // Volatility of the diffusion part
+    double lambda; // Jump intensity (jumps per year)
+    double muJ; // Mean of the log jump size
+    double deltaJ; // Standard deviation of the log jump size
+
+protected:
+    double compensator() const override; // -sigma^2 / 2 - lambda (exp(muJ + deltaJ^2 / 2) - 1)
+    void increments(double* X, std::size_t n, double dt, RNG& rng) const override; // sigma sqrt(dt) Z + k muJ + sqrt(k) deltaJ Z', k ~ Poisson(lambda dt)
+    std::complex<double> exponent(std::complex<double> u) const override; // -sigma^2 u^2 / 2 + lambda (exp(i u muJ - deltaJ^2 u^2 / 2) - 1)
+
+public:
+    MertonJumpDiffusion(double r, double sigma, double lambda, double muJ, double deltaJ); // Constructor for Merton's jump diffusion
+    std::string key() const override; // Model name and exact parameters
+};
+
+class Heston : public SDE
+{
+private:
+    double r; // Risk-free rate
+    double kappa; // Mean reversion speed of the variance
+    double theta; // Long-term variance
+    double xi; // Volatility of variance
+    double rho; // Correlation between the asset and its variance
+    double v0; // Initial variance
+
+public:
+    Heston(double r, double kappa, double theta, double xi, double rho, double v0); // Constructor for the Heston model
+    double drift(double S, double t) override; // Compute the drift term
+    double diffusion(double S, double t) override; // Not defined: the volatility depends on the variance path
+    std::string key() const override; // Model name and exact parameters
+    bool simulatesPaths() const override; // Paths carry their own variance
+    void simulateBlock(PathBlock& block, RNG& rng) override; // Log-Euler for S and full-truncation Euler for v
+    bool hasCharacteristicFunction() const override; // Affine model
+    std::complex<double> characteristicFunction(std::complex<double> u, double T) const override; // Albrecher et al. form, free of branch cuts
+};
+
+class StochasticLocalVol : public SDE
+{
+private:
+    struct Leverage
+    {
+        std::size_t bins; // Bins per time step
+        std::vector<double> lo; // Log-price of the lower edge of the first bin at each step
+        std::vector<double> width; // Bin width in log-price at each step
+        std::vector<double> values; // values[j * bins + b]: L at the centre of bin b at step j
+
+        double at(std::size_t j, double x) const; // L at log-price x and step j, linear between bin centres
+    };
+
+    double r; // Risk-free rate
+    double kappa; // Mean reversion speed of the variance
+    double theta; // Long-term variance
+    double xi; // Volatility of variance
+    double rho; // Correlation between the asset and its variance
+    double v0; // Initial variance
+    std::function<double(double, double)> localVol; // Target local volatility sigma(S, t)
+    std::size_t particles; // Particles used to calibrate L
+    std::size_t bins; // Bins of the conditional expectation E[v | S]
+    std::map<std::tuple<double, double, int>, std::shared_ptr<const Leverage>> calibrated; // Leverage per (S0, T, N)
+    std::mutex mutex; // Protects calibrated
+
+    void advance(double* x, double* v, std::size_t n, const Leverage& leverage, std::size_t j, double dt, const double* Z) const; // One step of log-prices x and variances v with 2n normals
+
+public:
+    static constexpr std::size_t sliceSize = 4096; // Particles advanced and binned by one task
+    static constexpr double shrinkage = 16.0; // Pseudo-particles at E[v] added to every bin of E[v | S]
+    static constexpr std::uint64_t calibrationStream = std::uint64_t(1) << 40; // First RNG stream used by calibration, clear of the solver's chunk streams
+
+    StochasticLocalVol(double r, double kappa, double theta, double xi, double rho, double v0, std::function<double(double, double)> localVol,
+        std::size_t particles = 65536, std::size_t bins = 64); // Constructor for the stochastic local volatility model
+    double drift(double S, double t) override; // Compute the drift term
+    double diffusion(double S, double t) override; // Not defined: the volatility depends on the variance path
+    bool simulatesPaths() const override; // Paths carry their own variance
+    void simulateBlock(PathBlock& block, RNG& rng) override; // Log-Euler for S and full-truncation Euler for v with the calibrated L
+    void calibrate(double S0, double T, int N, std::shared_ptr<RNG> rng) override; // Particle method: L(S, t)^2 = sigma(S, t)^2 / E[v | S]
 };
 
 #endif // SDE_HPP
\ No newline at end of file
@@ -0,0 +1,85 @@
+/*
+ * File: SPSCRing.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the SPSCRing class template, a lock-free single-producer/single-consumer ring of preallocated
+ * slots. The producer claims a free slot, fills it in place and publishes it; the consumer reads the oldest
+ * published slot in place and hands it back. Slots are never copied or reallocated, so large buffers (for example
+ * blocks of normal random numbers) can be passed between two threads with two atomic operations per slot.
+ * Exactly one thread may call the producer methods and exactly one other thread may call the consumer methods.
+ */
+
+#ifndef SPSCRING_HPP
+#define SPSCRING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+template <typename T>
+class SPSCRing
+{
+private:
+    static constexpr std::size_t cacheLine = 64; // Keep the two indices on separate cache lines
+
+    std::vector<T> slots; // Preallocated slot storage
+    alignas(cacheLine) std::atomic<std::size_t> head; // Number of slots published by the producer
+    alignas(cacheLine) std::atomic<std::size_t> tail; // Number of slots released by the consumer
+
+public:
+    explicit SPSCRing(std::size_t capacity, const T& prototype = T()) // Constructor, every slot starts as a copy of prototype
+        : slots(capacity, prototype), head(0), tail(0)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("SPSCRing capacity must be positive.");
+        }
+    }
+
+    SPSCRing(const SPSCRing&) = delete;
+    SPSCRing& operator=(const SPSCRing&) = delete;
+
+    // Producer side: return a free slot to fill, or nullptr if the ring is full
+    T* tryAcquireWrite()
+    {
+        std::size_t h = head.load(std::memory_order_relaxed); // Only the producer writes head
+        if (h - tail.load(std::memory_order_acquire) == slots.size())
+        {
+            return nullptr;
+        }
+        return &slots[h % slots.size()];
+    }
+
+    // Producer side: publish the slot returned by tryAcquireWrite()
+    void commitWrite()
+    {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer side: return the oldest published slot, or nullptr if the ring is empty
+    T* tryAcquireRead()
+    {
+        std::size_t t = tail.load(std::memory_order_relaxed); // Only the consumer writes tail
+        if (head.load(std::memory_order_acquire) == t)
+        {
+            return nullptr;
+        }
+        return &slots[t % slots.size()];
+    }
+
+    // Consumer side: give the slot returned by tryAcquireRead() back to the producer
+    void commitRead()
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    std::size_t capacity() const
+    {
+        return slots.size();
+    }
+};
+
+#endif // SPSCRING_HPP
\ No newline at end of file
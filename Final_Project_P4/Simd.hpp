@@ -0,0 +1,306 @@
+/*
+ * File: Simd.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines thin SIMD vector types of doubles, one per instruction set: Portable (one lane, plain C++),
+ * SSE2 (two lanes), AVX2 (four lanes) and AVX512 (eight lanes). They share one interface (broadcast construction,
+ * full and partial loads and stores, arithmetic, comparisons producing a Mask, select() to blend under a mask, and
+ * the math functions used by the model kernels), so a kernel written once as a template over the vector type
+ * compiles to every width. Partial loads and stores use the hardware masks where they exist, so the last vector of
+ * a row needs no scalar remainder loop. Conditional logic such as barrier hits and boundary policies is written as
+ * comparisons and selects under masks, never as branches.
+ * Like Dual, the types plug into the model Kernel templates and the FDM step templates through argument-dependent
+ * lookup: sqrt, exp, log and pow are found next to the type. sqrt is a vector instruction; exp, log and pow are
+ * evaluated lane by lane with the standard library so that vector and scalar results agree. Agreement across widths
+ * also needs every multiply and add rounded separately: the kernel files disable floating-point contraction, and
+ * code using these types elsewhere must not enable it if it relies on bit-identical results.
+ * Every function of the wider types carries its instruction set as a target attribute on GCC and Clang, so the
+ * header can be included anywhere; MSVC accepts the intrinsics in any translation unit.
+ */
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cmath>
+#include <cstddef>
+#include "Dispatch.hpp"
+
+#if defined(MC_X86)
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET(features) __attribute__((target(features)))
+#define SIMD_FLATTEN __attribute__((flatten)) // Inline the whole call tree, so template code written for any scalar type runs at the kernel's width
+#else
+#define SIMD_TARGET(features)
+#define SIMD_FLATTEN
+#endif
+
+namespace simd
+{
+    class Portable
+    {
+    public:
+        static constexpr std::size_t width = 1; // Number of lanes
+
+        struct Mask
+        {
+            bool lanes; // Result of a lane comparison
+        };
+
+        double v; // The single lane
+
+        Portable(double x = 0.0) : v(x) {}
+
+        static Portable load(const double* p) { return p[0]; }
+        static Portable load(const double* p, std::size_t m) { return m ? p[0] : 0.0; } // First m lanes, the others zero
+        void store(double* p) const { p[0] = v; }
+        void store(double* p, std::size_t m) const { if (m) p[0] = v; } // Only the first m lanes
+        double lane(std::size_t i) const { return v; }
+    };
+
+    inline Portable operator+(const Portable& a, const Portable& b) { return a.v + b.v; }
+    inline Portable operator-(const Portable& a, const Portable& b) { return a.v - b.v; }
+    inline Portable operator*(const Portable& a, const Portable& b) { return a.v * b.v; }
+    inline Portable operator/(const Portable& a, const Portable& b) { return a.v / b.v; }
+    inline Portable operator-(const Portable& a) { return -a.v; }
+    inline Portable::Mask operator<(const Portable& a, const Portable& b) { return { a.v < b.v }; }
+    inline Portable::Mask operator>(const Portable& a, const Portable& b) { return { a.v > b.v }; }
+    inline Portable::Mask operator<=(const Portable& a, const Portable& b) { return { a.v <= b.v }; }
+    inline Portable::Mask operator>=(const Portable& a, const Portable& b) { return { a.v >= b.v }; }
+    inline Portable::Mask operator&(Portable::Mask a, Portable::Mask b) { return { a.lanes && b.lanes }; }
+    inline Portable::Mask operator!(Portable::Mask a) { return { !a.lanes }; }
+    inline Portable select(Portable::Mask m, const Portable& a, const Portable& b) { return m.lanes ? a : b; } // a where m is set, else b
+    inline unsigned bits(Portable::Mask m) { return m.lanes; } // Bit i is lane i
+    inline Portable min(const Portable& a, const Portable& b) { return a.v < b.v ? a : b; }
+    inline Portable max(const Portable& a, const Portable& b) { return a.v > b.v ? a : b; }
+    inline Portable abs(const Portable& a) { return std::fabs(a.v); }
+    inline Portable sqrt(const Portable& a) { return std::sqrt(a.v); }
+    inline Portable exp(const Portable& a) { return std::exp(a.v); }
+    inline Portable log(const Portable& a) { return std::log(a.v); }
+    inline Portable pow(const Portable& a, const Portable& p) { return std::pow(a.v, p.v); }
+
+#if defined(MC_X86)
+#define SIMD_SSE2 SIMD_TARGET("sse2")
+
+    class SSE2
+    {
+    public:
+        static constexpr std::size_t width = 2; // Number of lanes
+
+        struct Mask
+        {
+            __m128d lanes; // All ones in the lanes where a comparison holds
+        };
+
+        __m128d v; // The two lanes
+
+        SIMD_SSE2 SSE2(double x = 0.0) : v(_mm_set1_pd(x)) {}
+        SIMD_SSE2 SSE2(__m128d x) : v(x) {}
+
+        SIMD_SSE2 static SSE2 load(const double* p) { return _mm_loadu_pd(p); }
+        SIMD_SSE2 static SSE2 load(const double* p, std::size_t m) { return m >= 2 ? _mm_loadu_pd(p) : m ? _mm_load_sd(p) : _mm_setzero_pd(); }
+        SIMD_SSE2 void store(double* p) const { _mm_storeu_pd(p, v); }
+        SIMD_SSE2 void store(double* p, std::size_t m) const
+        {
+            if (m >= 2)
+            {
+                _mm_storeu_pd(p, v);
+            }
+            else if (m)
+            {
+                _mm_store_sd(p, v); // SSE2 has no masked store: write the low lane alone
+            }
+        }
+        SIMD_SSE2 double lane(std::size_t i) const { alignas(16) double x[2]; _mm_store_pd(x, v); return x[i]; }
+    };
+
+    SIMD_SSE2 inline SSE2 operator+(const SSE2& a, const SSE2& b) { return _mm_add_pd(a.v, b.v); }
+    SIMD_SSE2 inline SSE2 operator-(const SSE2& a, const SSE2& b) { return _mm_sub_pd(a.v, b.v); }
+    SIMD_SSE2 inline SSE2 operator*(const SSE2& a, const SSE2& b) { return _mm_mul_pd(a.v, b.v); }
+    SIMD_SSE2 inline SSE2 operator/(const SSE2& a, const SSE2& b) { return _mm_div_pd(a.v, b.v); }
+    SIMD_SSE2 inline SSE2 operator-(const SSE2& a) { return _mm_xor_pd(a.v, _mm_set1_pd(-0.0)); }
+    SIMD_SSE2 inline SSE2::Mask operator<(const SSE2& a, const SSE2& b) { return { _mm_cmplt_pd(a.v, b.v) }; }
+    SIMD_SSE2 inline SSE2::Mask operator>(const SSE2& a, const SSE2& b) { return { _mm_cmpgt_pd(a.v, b.v) }; }
+    SIMD_SSE2 inline SSE2::Mask operator<=(const SSE2& a, const SSE2& b) { return { _mm_cmple_pd(a.v, b.v) }; }
+    SIMD_SSE2 inline SSE2::Mask operator>=(const SSE2& a, const SSE2& b) { return { _mm_cmpge_pd(a.v, b.v) }; }
+    SIMD_SSE2 inline SSE2::Mask operator&(SSE2::Mask a, SSE2::Mask b) { return { _mm_and_pd(a.lanes, b.lanes) }; }
+    SIMD_SSE2 inline SSE2::Mask operator!(SSE2::Mask a) { return { _mm_xor_pd(a.lanes, _mm_castsi128_pd(_mm_set1_epi32(-1))) }; }
+    SIMD_SSE2 inline SSE2 select(SSE2::Mask m, const SSE2& a, const SSE2& b) { return _mm_or_pd(_mm_and_pd(m.lanes, a.v), _mm_andnot_pd(m.lanes, b.v)); }
+    SIMD_SSE2 inline unsigned bits(SSE2::Mask m) { return static_cast<unsigned>(_mm_movemask_pd(m.lanes)); }
+    SIMD_SSE2 inline SSE2 min(const SSE2& a, const SSE2& b) { return _mm_min_pd(a.v, b.v); }
+    SIMD_SSE2 inline SSE2 max(const SSE2& a, const SSE2& b) { return _mm_max_pd(a.v, b.v); }
+    SIMD_SSE2 inline SSE2 abs(const SSE2& a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a.v); }
+    SIMD_SSE2 inline SSE2 sqrt(const SSE2& a) { return _mm_sqrt_pd(a.v); }
+    SIMD_SSE2 inline SSE2 exp(const SSE2& a) { return _mm_setr_pd(std::exp(a.lane(0)), std::exp(a.lane(1))); }
+    SIMD_SSE2 inline SSE2 log(const SSE2& a) { return _mm_setr_pd(std::log(a.lane(0)), std::log(a.lane(1))); }
+    SIMD_SSE2 inline SSE2 pow(const SSE2& a, const SSE2& p) { return _mm_setr_pd(std::pow(a.lane(0), p.lane(0)), std::pow(a.lane(1), p.lane(1))); }
+
+#define SIMD_AVX2 SIMD_TARGET("avx2,fma")
+
+    class AVX2
+    {
+    public:
+        static constexpr std::size_t width = 4; // Number of lanes
+
+        struct Mask
+        {
+            __m256d lanes; // All ones in the lanes where a comparison holds
+        };
+
+        __m256d v; // The four lanes
+
+        SIMD_AVX2 AVX2(double x = 0.0) : v(_mm256_set1_pd(x)) {}
+        SIMD_AVX2 AVX2(__m256d x) : v(x) {}
+
+        SIMD_AVX2 static __m256i first(std::size_t m) // Lane mask of the first m lanes
+        {
+            return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(m)), _mm256_setr_epi64x(0, 1, 2, 3));
+        }
+        SIMD_AVX2 static AVX2 load(const double* p) { return _mm256_loadu_pd(p); }
+        SIMD_AVX2 static AVX2 load(const double* p, std::size_t m) { return m >= width ? _mm256_loadu_pd(p) : _mm256_maskload_pd(p, first(m)); }
+        SIMD_AVX2 void store(double* p) const { _mm256_storeu_pd(p, v); }
+        SIMD_AVX2 void store(double* p, std::size_t m) const
+        {
+            if (m >= width)
+            {
+                _mm256_storeu_pd(p, v);
+            }
+            else
+            {
+                _mm256_maskstore_pd(p, first(m), v); // Lanes past the row are neither read nor written
+            }
+        }
+        SIMD_AVX2 double lane(std::size_t i) const { alignas(32) double x[4]; _mm256_store_pd(x, v); return x[i]; }
+    };
+
+    SIMD_AVX2 inline AVX2 operator+(const AVX2& a, const AVX2& b) { return _mm256_add_pd(a.v, b.v); }
+    SIMD_AVX2 inline AVX2 operator-(const AVX2& a, const AVX2& b) { return _mm256_sub_pd(a.v, b.v); }
+    SIMD_AVX2 inline AVX2 operator*(const AVX2& a, const AVX2& b) { return _mm256_mul_pd(a.v, b.v); }
+    SIMD_AVX2 inline AVX2 operator/(const AVX2& a, const AVX2& b) { return _mm256_div_pd(a.v, b.v); }
+    SIMD_AVX2 inline AVX2 operator-(const AVX2& a) { return _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0)); }
+    SIMD_AVX2 inline AVX2::Mask operator<(const AVX2& a, const AVX2& b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ) }; }
+    SIMD_AVX2 inline AVX2::Mask operator>(const AVX2& a, const AVX2& b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ) }; }
+    SIMD_AVX2 inline AVX2::Mask operator<=(const AVX2& a, const AVX2& b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ) }; }
+    SIMD_AVX2 inline AVX2::Mask operator>=(const AVX2& a, const AVX2& b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ) }; }
+    SIMD_AVX2 inline AVX2::Mask operator&(AVX2::Mask a, AVX2::Mask b) { return { _mm256_and_pd(a.lanes, b.lanes) }; }
+    SIMD_AVX2 inline AVX2::Mask operator!(AVX2::Mask a) { return { _mm256_xor_pd(a.lanes, _mm256_castsi256_pd(_mm256_set1_epi32(-1))) }; }
+    SIMD_AVX2 inline AVX2 select(AVX2::Mask m, const AVX2& a, const AVX2& b) { return _mm256_blendv_pd(b.v, a.v, m.lanes); }
+    SIMD_AVX2 inline unsigned bits(AVX2::Mask m) { return static_cast<unsigned>(_mm256_movemask_pd(m.lanes)); }
+    SIMD_AVX2 inline AVX2 min(const AVX2& a, const AVX2& b) { return _mm256_min_pd(a.v, b.v); }
+    SIMD_AVX2 inline AVX2 max(const AVX2& a, const AVX2& b) { return _mm256_max_pd(a.v, b.v); }
+    SIMD_AVX2 inline AVX2 abs(const AVX2& a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v); }
+    SIMD_AVX2 inline AVX2 sqrt(const AVX2& a) { return _mm256_sqrt_pd(a.v); }
+    SIMD_AVX2 inline AVX2 exp(const AVX2& a)
+    {
+        alignas(32) double x[4];
+        _mm256_store_pd(x, a.v);
+        for (double& xi : x)
+        {
+            xi = std::exp(xi);
+        }
+        return _mm256_load_pd(x);
+    }
+    SIMD_AVX2 inline AVX2 log(const AVX2& a)
+    {
+        alignas(32) double x[4];
+        _mm256_store_pd(x, a.v);
+        for (double& xi : x)
+        {
+            xi = std::log(xi);
+        }
+        return _mm256_load_pd(x);
+    }
+    SIMD_AVX2 inline AVX2 pow(const AVX2& a, const AVX2& p)
+    {
+        alignas(32) double x[4], y[4];
+        _mm256_store_pd(x, a.v);
+        _mm256_store_pd(y, p.v);
+        for (int i = 0; i < 4; ++i)
+        {
+            x[i] = std::pow(x[i], y[i]);
+        }
+        return _mm256_load_pd(x);
+    }
+
+#define SIMD_AVX512 SIMD_TARGET("avx512f,avx512dq")
+
+    class AVX512
+    {
+    public:
+        static constexpr std::size_t width = 8; // Number of lanes
+
+        struct Mask
+        {
+            __mmask8 lanes; // Bit i is set where the comparison holds in lane i
+        };
+
+        __m512d v; // The eight lanes
+
+        SIMD_AVX512 AVX512(double x = 0.0) : v(_mm512_set1_pd(x)) {}
+        SIMD_AVX512 AVX512(__m512d x) : v(x) {}
+
+        SIMD_AVX512 static __mmask8 first(std::size_t m) { return static_cast<__mmask8>(m >= width ? 0xFF : (1u << m) - 1); } // First m lanes
+        SIMD_AVX512 static AVX512 load(const double* p) { return _mm512_loadu_pd(p); }
+        SIMD_AVX512 static AVX512 load(const double* p, std::size_t m) { return _mm512_maskz_loadu_pd(first(m), p); }
+        SIMD_AVX512 void store(double* p) const { _mm512_storeu_pd(p, v); }
+        SIMD_AVX512 void store(double* p, std::size_t m) const { _mm512_mask_storeu_pd(p, first(m), v); }
+        SIMD_AVX512 double lane(std::size_t i) const { alignas(64) double x[8]; _mm512_store_pd(x, v); return x[i]; }
+    };
+
+    SIMD_AVX512 inline AVX512 operator+(const AVX512& a, const AVX512& b) { return _mm512_add_pd(a.v, b.v); }
+    SIMD_AVX512 inline AVX512 operator-(const AVX512& a, const AVX512& b) { return _mm512_sub_pd(a.v, b.v); }
+    SIMD_AVX512 inline AVX512 operator*(const AVX512& a, const AVX512& b) { return _mm512_mul_pd(a.v, b.v); }
+    SIMD_AVX512 inline AVX512 operator/(const AVX512& a, const AVX512& b) { return _mm512_div_pd(a.v, b.v); }
+    SIMD_AVX512 inline AVX512 operator-(const AVX512& a) { return _mm512_xor_pd(a.v, _mm512_set1_pd(-0.0)); }
+    SIMD_AVX512 inline AVX512::Mask operator<(const AVX512& a, const AVX512& b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ) }; }
+    SIMD_AVX512 inline AVX512::Mask operator>(const AVX512& a, const AVX512& b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ) }; }
+    SIMD_AVX512 inline AVX512::Mask operator<=(const AVX512& a, const AVX512& b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_LE_OQ) }; }
+    SIMD_AVX512 inline AVX512::Mask operator>=(const AVX512& a, const AVX512& b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_GE_OQ) }; }
+    SIMD_AVX512 inline AVX512::Mask operator&(AVX512::Mask a, AVX512::Mask b) { return { static_cast<__mmask8>(a.lanes & b.lanes) }; }
+    SIMD_AVX512 inline AVX512::Mask operator!(AVX512::Mask a) { return { static_cast<__mmask8>(~a.lanes) }; }
+    SIMD_AVX512 inline AVX512 select(AVX512::Mask m, const AVX512& a, const AVX512& b) { return _mm512_mask_blend_pd(m.lanes, b.v, a.v); }
+    SIMD_AVX512 inline unsigned bits(AVX512::Mask m) { return m.lanes; }
+    // All-lane forms of the masked instructions: the unmasked intrinsics of some GCC 12 releases warn about an undefined source
+    SIMD_AVX512 inline AVX512 min(const AVX512& a, const AVX512& b) { return _mm512_mask_min_pd(a.v, 0xFF, a.v, b.v); }
+    SIMD_AVX512 inline AVX512 max(const AVX512& a, const AVX512& b) { return _mm512_mask_max_pd(a.v, 0xFF, a.v, b.v); }
+    SIMD_AVX512 inline AVX512 abs(const AVX512& a) { return _mm512_abs_pd(a.v); }
+    SIMD_AVX512 inline AVX512 sqrt(const AVX512& a) { return _mm512_mask_sqrt_pd(a.v, 0xFF, a.v); }
+    SIMD_AVX512 inline AVX512 exp(const AVX512& a)
+    {
+        alignas(64) double x[8];
+        _mm512_store_pd(x, a.v);
+        for (double& xi : x)
+        {
+            xi = std::exp(xi);
+        }
+        return _mm512_load_pd(x);
+    }
+    SIMD_AVX512 inline AVX512 log(const AVX512& a)
+    {
+        alignas(64) double x[8];
+        _mm512_store_pd(x, a.v);
+        for (double& xi : x)
+        {
+            xi = std::log(xi);
+        }
+        return _mm512_load_pd(x);
+    }
+    SIMD_AVX512 inline AVX512 pow(const AVX512& a, const AVX512& p)
+    {
+        alignas(64) double x[8], y[8];
+        _mm512_store_pd(x, a.v);
+        _mm512_store_pd(y, p.v);
+        for (int i = 0; i < 8; ++i)
+        {
+            x[i] = std::pow(x[i], y[i]);
+        }
+        return _mm512_load_pd(x);
+    }
+#endif
+}
+
+#endif // SIMD_HPP
\ No newline at end of file
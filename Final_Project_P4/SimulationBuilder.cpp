@@ -76,7 +76,10 @@ std::shared_ptr<SDE> SimulationBuilder::selectSDE()
 {
     int choice;
     std::cout << "Select SDE Model:\n";
-    std::cout << "1. GBM\n2. CEV\n3. CIR\n";
+    std::cout << "1. GBM\n2. CEV\n3. CIR\n4. Rough Bergomi (simulates its own paths; the FDM choice is ignored)\n"
+              << "5. Variance Gamma (exact subordination; the FDM choice is ignored)\n6. Normal Inverse Gaussian (exact subordination; the FDM choice is ignored)\n"
+              << "7. Stochastic Local Volatility (particle-calibrated; the FDM choice is ignored)\n"
+              << "8. Heston (simulates its own paths; the FDM choice is ignored)\n9. Merton Jump Diffusion (exact; the FDM choice is ignored)\n";
     std::cin >> choice;
 
     if (std::cin.fail())
@@ -94,6 +97,19 @@ std::shared_ptr<SDE> SimulationBuilder::selectSDE()
         return std::make_shared<CEV>(0.05, 0.2, 0.5); // Create CEV model with default parameters
     case 3:
         return std::make_shared<CIR>(0.1, 0.2, 0.3); // Create CIR model with default parameters
+    case 4:
+        return std::make_shared<RoughBergomi>(0.05, 0.04, 1.9, 0.07, -0.9); // Create rough Bergomi model with default parameters
+    case 5:
+        return std::make_shared<VarianceGamma>(0.05, 0.12, 0.2, -0.14); // Create Variance Gamma model with default parameters
+    case 6:
+        return std::make_shared<NormalInverseGaussian>(0.05, 15.0, -5.0, 0.5); // Create Normal Inverse Gaussian model with default parameters
+    case 7:
+        return std::make_shared<StochasticLocalVol>(0.05, 1.5, 0.04, 0.5, -0.7, 0.04,
+            [](double S, double t) { return 0.2 * std::pow(S / 100.0, -0.3); }); // Create SLV model reproducing a skewed local volatility
+    case 8:
+        return std::make_shared<Heston>(0.05, 1.5, 0.04, 0.5, -0.7, 0.04); // Create Heston model with default parameters
+    case 9:
+        return std::make_shared<MertonJumpDiffusion>(0.05, 0.15, 0.5, -0.1, 0.15); // Create Merton jump diffusion with default parameters
     default:
         std::cout << "Invalid choice. Please select again.\n";
         return selectSDE(); // Recursively prompt for valid input
@@ -109,7 +125,8 @@ std::shared_ptr<FDM> SimulationBuilder::selectFDM(std::shared_ptr<SDE> sde)
 
     int choice;
     std::cout << "Select FDM Scheme:\n";
-    std::cout << "1. EulerMethod\n2. MilsteinMethod\n3. DriftAdjustedPredictorCorrector\n";
+    std::cout << "1. EulerMethod\n2. MilsteinMethod\n3. DriftAdjustedPredictorCorrector\n"
+              << "4. ExactTransition (GBM, Variance Gamma, NIG, Merton; samples only the payoff's observation dates)\n";
     std::cin >> choice;
 
     if (std::cin.fail())
@@ -127,17 +144,54 @@ std::shared_ptr<FDM> SimulationBuilder::selectFDM(std::shared_ptr<SDE> sde)
         return std::make_shared<MilsteinMethod>(sde); // Create Milstein method
     case 3:
         return std::make_shared<DriftAdjustedPredictorCorrector>(sde); // Create Drift-Adjusted Predictor-Corrector method
+    case 4:
+        if (!sde->hasExactTransition())
+        {
+            std::cout << "This model has no exact transition law. Please select again.\n";
+            return selectFDM(sde); // Recursively prompt for a scheme the model supports
+        }
+        return std::make_shared<ExactTransition>(sde); // Sample the exact law, on the observation dates where possible
     default:
         std::cout << "Invalid choice. Please select again.\n";
         return selectFDM(sde); // Recursively prompt for valid input
     }
 }
 
+Boundary SimulationBuilder::selectBoundary()
+{
+    int choice;
+    std::cout << "Select boundary policy for negative prices:\n";
+    std::cout << "1. Absorb at zero\n2. Reflect\n3. Truncate\n4. Reject path\n";
+    std::cin >> choice;
+
+    if (std::cin.fail())
+    {
+        std::cin.clear(); // Clear error state
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Ignore invalid input
+        throw std::invalid_argument("Invalid input. Please enter a number.");
+    }
+
+    switch (choice)
+    {
+    case 1:
+        return Boundary::Absorb; // Zero stays zero
+    case 2:
+        return Boundary::Reflect; // Mirror negative prices back above zero
+    case 3:
+        return Boundary::Truncate; // Clamp to zero and keep evolving
+    case 4:
+        return Boundary::Reject; // Drop the path from the estimates
+    default:
+        std::cout << "Invalid choice. Please select again.\n";
+        return selectBoundary(); // Recursively prompt for valid input
+    }
+}
+
 std::shared_ptr<RNG> SimulationBuilder::selectRNG()
 {
     int choice;
     std::cout << "Select RNG:\n";
-    std::cout << "1. MersenneTwister\n";
+    std::cout << "1. MersenneTwister\n2. MersenneTwister (pipelined on a producer thread)\n3. MersenneTwister (moment-matched per time step)\n";
     std::cin >> choice;
 
     if (std::cin.fail())
@@ -151,6 +205,10 @@ std::shared_ptr<RNG> SimulationBuilder::selectRNG()
     {
     case 1:
         return std::make_shared<MersenneTwister>(); // Create Mersenne Twister RNG
+    case 2:
+        return std::make_shared<PipelinedRNG>(std::make_shared<MersenneTwister>()); // Generate normals ahead on a producer thread
+    case 3:
+        return std::make_shared<MomentMatchedRNG>(std::make_shared<MersenneTwister>()); // Exact first two moments of every step's increments
     default:
         std::cout << "Invalid choice. Please select again.\n";
         return selectRNG(); // Recursively prompt for valid input
@@ -173,6 +231,10 @@ std::shared_ptr<Payoff> SimulationBuilder::selectPayoff()
     std::cout << "10. Down-and-In Put\n";
     std::cout << "11. Down-and-Out Call\n";
     std::cout << "12. Down-and-Out Put\n";
+    std::cout << "13. Discrete Asian Call (12 equally spaced fixings)\n";
+    std::cout << "14. Discrete Asian Put (12 equally spaced fixings)\n";
+    std::cout << "15. Digital Call\n";
+    std::cout << "16. Digital Put\n";
     std::cin >> choice;
 
     if (std::cin.fail())
@@ -184,9 +246,11 @@ std::shared_ptr<Payoff> SimulationBuilder::selectPayoff()
 
     double K = getStrikePrice(); // Get strike price from user
     double B = 0.0; // Barrier level (only used for barrier options)
-    bool isCall = false; // Flag for call/put
-    bool isUp = false; // Flag for up/down barrier
-    bool isIn = false; // Flag for in/out barrier
+    std::vector<double> fixings; // Fixing dates (only used for discrete Asian options)
+    for (int i = 1; i <= 12; ++i)
+    {
+        fixings.push_back(T * i / 12); // Equally spaced up to maturity
+    }
 
     switch (choice)
     {
@@ -200,52 +264,36 @@ std::shared_ptr<Payoff> SimulationBuilder::selectPayoff()
         return std::make_shared<AsianOption>(K, false); // Create Asian Put payoff
     case 5:
         B = getBarrierLevel(); // Get barrier level for barrier options
-        isCall = true;
-        isUp = true;
-        isIn = true;
-        return std::make_shared<BarrierOption>(K, B, isCall, isUp, isIn); // Create Up-and-In Call payoff
+        return std::make_shared<BarrierOption<true, true, true>>(K, B); // Create Up-and-In Call payoff
     case 6:
         B = getBarrierLevel();
-        isCall = false;
-        isUp = true;
-        isIn = true;
-        return std::make_shared<BarrierOption>(K, B, isCall, isUp, isIn); // Create Up-and-In Put payoff
+        return std::make_shared<BarrierOption<false, true, true>>(K, B); // Create Up-and-In Put payoff
     case 7:
         B = getBarrierLevel();
-        isCall = true;
-        isUp = true;
-        isIn = false;
-        return std::make_shared<BarrierOption>(K, B, isCall, isUp, isIn); // Create Up-and-Out Call payoff
+        return std::make_shared<BarrierOption<true, true, false>>(K, B); // Create Up-and-Out Call payoff
     case 8:
         B = getBarrierLevel();
-        isCall = false;
-        isUp = true;
-        isIn = false;
-        return std::make_shared<BarrierOption>(K, B, isCall, isUp, isIn); // Create Up-and-Out Put payoff
+        return std::make_shared<BarrierOption<false, true, false>>(K, B); // Create Up-and-Out Put payoff
     case 9:
         B = getBarrierLevel();
-        isCall = true;
-        isUp = false;
-        isIn = true;
-        return std::make_shared<BarrierOption>(K, B, isCall, isUp, isIn); // Create Down-and-In Call payoff
+        return std::make_shared<BarrierOption<true, false, true>>(K, B); // Create Down-and-In Call payoff
     case 10:
         B = getBarrierLevel();
-        isCall = false;
-        isUp = false;
-        isIn = true;
-        return std::make_shared<BarrierOption>(K, B, isCall, isUp, isIn); // Create Down-and-In Put payoff
+        return std::make_shared<BarrierOption<false, false, true>>(K, B); // Create Down-and-In Put payoff
     case 11:
         B = getBarrierLevel();
-        isCall = true;
-        isUp = false;
-        isIn = false;
-        return std::make_shared<BarrierOption>(K, B, isCall, isUp, isIn); // Create Down-and-Out Call payoff
+        return std::make_shared<BarrierOption<true, false, false>>(K, B); // Create Down-and-Out Call payoff
     case 12:
         B = getBarrierLevel();
-        isCall = false;
-        isUp = false;
-        isIn = false;
-        return std::make_shared<BarrierOption>(K, B, isCall, isUp, isIn); // Create Down-and-Out Put payoff
+        return std::make_shared<BarrierOption<false, false, false>>(K, B); // Create Down-and-Out Put payoff
+    case 13:
+        return std::make_shared<DiscreteAsianOption>(K, true, fixings); // Create Discrete Asian Call payoff
+    case 14:
+        return std::make_shared<DiscreteAsianOption>(K, false, fixings); // Create Discrete Asian Put payoff
+    case 15:
+        return std::make_shared<DigitalOption>(K, true); // Create Digital Call payoff
+    case 16:
+        return std::make_shared<DigitalOption>(K, false); // Create Digital Put payoff
     default:
         std::cout << "Invalid choice. Please select again.\n";
         return selectPayoff(); // Recursively prompt for valid input
@@ -306,6 +354,7 @@ SimulationBuilder& SimulationBuilder::configureFromUser()
         // Select components
         sde = selectSDE(); // Select SDE model
         fdm = selectFDM(sde); // Select FDM scheme
+        sde->setBoundary(selectBoundary()); // Select what happens to negative prices
         rng = selectRNG(); // Select RNG
         payoff = selectPayoff(); // Select Payoff function
     }
@@ -36,6 +36,7 @@ private:
 
     std::shared_ptr<SDE> selectSDE();                           // Helper method to select SDE model
     std::shared_ptr<FDM> selectFDM(std::shared_ptr<SDE> sde);   // Helper method to select FDM scheme
+    Boundary selectBoundary();                                  // Helper method to select the boundary policy
     std::shared_ptr<RNG> selectRNG();                           // Helper method to select RNG
     std::shared_ptr<Payoff> selectPayoff();                     // Helper method to select Payoff function
     double getStrikePrice();                                    // Helper method to get strike price from user
@@ -0,0 +1,129 @@
+/*
+ * File: SimulationQueue.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the SimulationQueue class. A fingerprint combines the exact keys of the SDE and FDM with
+ * the SDE's boundary policy and S0, T and N written as hexadecimal floats, so two jobs share a group only if they
+ * would generate identical paths from identical normals. Components that cannot describe themselves fall back to their address, which still fuses
+ * jobs built from the same objects. Fused groups run concurrently on the shared ThreadPool.
+ */
+
+#include "SimulationQueue.hpp"
+#include <algorithm>
+#include <sstream>
+
+SimulationQueue::SimulationQueue() : count(0)
+{
+}
+
+std::string SimulationQueue::fingerprint(const Config& config)
+{
+    std::ostringstream out;
+    std::string sdeKey = std::get<0>(config)->key();
+    std::string fdmKey = std::get<1>(config)->key();
+
+    if (sdeKey.empty())
+    {
+        out << "sde@" << std::get<0>(config).get(); // Unknown model: only the same object is compatible
+    }
+    else
+    {
+        out << sdeKey;
+    }
+    out << '|';
+    if (fdmKey.empty())
+    {
+        out << "fdm@" << std::get<1>(config).get(); // Unknown scheme: only the same object is compatible
+    }
+    else
+    {
+        out << fdmKey;
+    }
+    out << '|' << static_cast<int>(std::get<0>(config)->boundary()); // Boundary policies change the paths
+    out << '|' << std::hexfloat << std::get<4>(config) << '|' << std::get<5>(config) << '|' << std::get<6>(config); // S0, T, N
+    return out.str();
+}
+
+std::future<double> SimulationQueue::enqueue(std::shared_ptr<SimulationBuilder> builder, const Schedule& schedule)
+{
+    if (!builder)
+    {
+        throw std::invalid_argument("SimulationBuilder pointer is null.");
+    }
+    return enqueue(builder->build(), schedule);
+}
+
+std::future<double> SimulationQueue::enqueue(const Config& config, const Schedule& schedule)
+{
+    MCSolver validate(config); // Reject invalid configurations now rather than at flush time
+    std::string key = fingerprint(config);
+
+    Job job{ config, std::promise<double>(), schedule };
+    std::future<double> result = job.price.get_future();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    groups[key].push_back(std::move(job));
+    ++count;
+    return result;
+}
+
+std::size_t SimulationQueue::pending()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return count;
+}
+
+std::size_t SimulationQueue::flush()
+{
+    std::map<std::string, std::vector<Job>> batch; // Take the queued jobs so new ones can be queued meanwhile
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch.swap(groups);
+        count = 0;
+    }
+
+    TaskGroup tasks;
+    for (auto& group : batch)
+    {
+        std::vector<Job>* jobs = &group.second;
+        Schedule urgent = jobs->front().schedule; // The group is as urgent as its most urgent job
+        for (const Job& job : *jobs)
+        {
+            urgent.priority = std::max(urgent.priority, job.schedule.priority);
+            urgent.deadline = std::min(urgent.deadline, job.schedule.deadline);
+        }
+        tasks.run([jobs]() { runGroup(*jobs); }, urgent); // Each fused group is one solve on the pool
+    }
+    tasks.wait();
+    return batch.size();
+}
+
+void SimulationQueue::runGroup(std::vector<Job>& jobs)
+{
+    std::vector<std::shared_ptr<Payoff>> payoffs;
+    std::vector<int> paths;
+    for (const Job& job : jobs)
+    {
+        payoffs.push_back(std::get<3>(job.config));
+        paths.push_back(std::get<7>(job.config));
+    }
+
+    try
+    {
+        MCSolver solver(jobs.front().config); // The first job supplies the path-generating components and RNG
+        std::vector<double> prices = solver.solve(payoffs, paths);
+        for (std::size_t k = 0; k < jobs.size(); ++k)
+        {
+            jobs[k].price.set_value(prices[k]); // Split the fused result back out per job
+        }
+    }
+    catch (...)
+    {
+        for (Job& job : jobs)
+        {
+            job.price.set_exception(std::current_exception()); // A failed simulation fails every job that shared it
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+ * File: SimulationQueue.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the SimulationQueue class, a queueing layer in front of the Monte Carlo solver that fuses
+ * compatible jobs. Every queued job is fingerprinted by the part of its configuration that generates paths
+ * (SDE, FDM, S0, T and N). On flush(), jobs with the same fingerprint are priced together as one multi-payoff
+ * simulation on a shared set of paths, and each job's price is delivered through its own future.
+ * Jobs of one group may ask for different numbers of simulations; the group simulates the largest count and each
+ * job averages over its own leading paths. The RNG of the first job in a group drives the whole group.
+ * A fused group runs with the most urgent Schedule among its jobs: the highest priority and the earliest deadline.
+ */
+
+#ifndef SIMULATIONQUEUE_HPP
+#define SIMULATIONQUEUE_HPP
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "SimulationBuilder.hpp"
+#include "MCSolver.hpp"
+#include "ThreadPool.hpp"
+
+class SimulationQueue
+{
+public:
+    using Config = std::tuple<std::shared_ptr<SDE>, std::shared_ptr<FDM>, std::shared_ptr<RNG>, std::shared_ptr<Payoff>, double, double, int, int>;
+
+private:
+    struct Job
+    {
+        Config config; // Built simulation configuration
+        std::promise<double> price; // Delivers the job's price
+        Schedule schedule; // Priority and deadline requested for the job
+    };
+
+    std::map<std::string, std::vector<Job>> groups; // Queued jobs grouped by path-generating fingerprint
+    std::size_t count; // Number of queued jobs
+    std::mutex mutex; // Protects groups and count
+
+    static void runGroup(std::vector<Job>& jobs); // Price one fused group and fulfil its promises
+
+public:
+    SimulationQueue(); // Constructor
+
+    static std::string fingerprint(const Config& config); // Key shared by jobs that can reuse each other's paths
+
+    std::future<double> enqueue(std::shared_ptr<SimulationBuilder> builder, const Schedule& schedule = Schedule::current()); // Build the configuration and queue the job
+    std::future<double> enqueue(const Config& config, const Schedule& schedule = Schedule::current()); // Queue an already built configuration
+    std::size_t pending(); // Number of queued jobs
+    std::size_t flush(); // Run every queued job, fused by fingerprint; returns the number of simulations run
+};
+
+#endif // SIMULATIONQUEUE_HPP
\ No newline at end of file
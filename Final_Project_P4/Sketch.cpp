@@ -0,0 +1,178 @@
+/*
+ * File: Sketch.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the QuantileSketch class. Buckets are visited in increasing order of value: the negative
+ * store from its largest bucket down, then the zeros, then the positive store from its smallest bucket up. Moments
+ * of two sketches are combined with the parallel formula of Chan, Golub and LeVeque.
+ */
+
+#include "Sketch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QuantileSketch::QuantileSketch(double accuracy)
+    : accuracy(accuracy), logGamma(0.0), zeros(0), n(0), average(0.0), squares(0.0),
+      lowest(std::numeric_limits<double>::infinity()), highest(-std::numeric_limits<double>::infinity())
+{
+    if (accuracy <= 0 || accuracy >= 1)
+    {
+        throw std::invalid_argument("Sketch accuracy must lie in (0, 1).");
+    }
+    logGamma = std::log((1 + accuracy) / (1 - accuracy));
+}
+
+int QuantileSketch::bucket(double magnitude) const
+{
+    return static_cast<int>(std::ceil(std::log(magnitude) / logGamma));
+}
+
+double QuantileSketch::representative(int index) const
+{
+    return 2 * std::exp(index * logGamma) / (1 + std::exp(logGamma)); // Midpoint in relative terms of (gamma^(i-1), gamma^i]
+}
+
+void QuantileSketch::add(double x)
+{
+    if (!std::isfinite(x))
+    {
+        throw std::invalid_argument("Cannot add NaN or an infinite value to a sketch."); // Neither has a bucket
+    }
+    if (x > minMagnitude)
+    {
+        ++positive[bucket(x)];
+    }
+    else if (x < -minMagnitude)
+    {
+        ++negative[bucket(-x)];
+    }
+    else
+    {
+        ++zeros;
+    }
+
+    ++n;
+    double deviation = x - average;
+    average += deviation / n;
+    squares += deviation * (x - average);
+    lowest = std::min(lowest, x);
+    highest = std::max(highest, x);
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    if (other.accuracy != accuracy)
+    {
+        throw std::invalid_argument("Only sketches with the same accuracy can be merged.");
+    }
+    if (other.n == 0)
+    {
+        return;
+    }
+    for (const auto& [index, c] : other.positive)
+    {
+        positive[index] += c;
+    }
+    for (const auto& [index, c] : other.negative)
+    {
+        negative[index] += c;
+    }
+    zeros += other.zeros;
+
+    double total = static_cast<double>(n + other.n);
+    double deviation = other.average - average;
+    squares += other.squares + deviation * deviation * n * other.n / total;
+    average += deviation * other.n / total;
+    n += other.n;
+    lowest = std::min(lowest, other.lowest);
+    highest = std::max(highest, other.highest);
+}
+
+std::uint64_t QuantileSketch::count() const
+{
+    return n;
+}
+
+double QuantileSketch::mean() const
+{
+    return average;
+}
+
+double QuantileSketch::stdev() const
+{
+    return n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+}
+
+double QuantileSketch::min() const
+{
+    return lowest;
+}
+
+double QuantileSketch::max() const
+{
+    return highest;
+}
+
+double QuantileSketch::quantile(double q) const
+{
+    if (n == 0 || q < 0 || q > 1)
+    {
+        throw std::invalid_argument("Quantiles need a non-empty sketch and q in [0, 1].");
+    }
+    double rank = q * (n - 1); // Zero-based rank of the requested sample
+    double seen = 0;
+    for (auto it = negative.rbegin(); it != negative.rend(); ++it)
+    {
+        seen += it->second;
+        if (seen > rank)
+        {
+            return std::clamp(-representative(it->first), lowest, highest);
+        }
+    }
+    seen += zeros;
+    if (seen > rank)
+    {
+        return 0.0;
+    }
+    for (const auto& [index, c] : positive)
+    {
+        seen += c;
+        if (seen > rank)
+        {
+            return std::clamp(representative(index), lowest, highest);
+        }
+    }
+    return highest;
+}
+
+double QuantileSketch::tailMean(double q) const
+{
+    if (n == 0 || q <= 0 || q > 1)
+    {
+        throw std::invalid_argument("Tail means need a non-empty sketch and q in (0, 1].");
+    }
+    double wanted = q * n; // Number of lowest samples to average
+    double taken = 0, sum = 0;
+    auto take = [&](double value, double c)
+    {
+        double used = std::min(c, wanted - taken); // The last bucket may be only partly inside the tail
+        sum += used * std::clamp(value, lowest, highest);
+        taken += used;
+    };
+    for (auto it = negative.rbegin(); it != negative.rend() && taken < wanted; ++it)
+    {
+        take(-representative(it->first), static_cast<double>(it->second));
+    }
+    if (taken < wanted)
+    {
+        take(0.0, static_cast<double>(zeros));
+    }
+    for (auto it = positive.begin(); it != positive.end() && taken < wanted; ++it)
+    {
+        take(representative(it->first), static_cast<double>(it->second));
+    }
+    return sum / taken;
+}
\ No newline at end of file
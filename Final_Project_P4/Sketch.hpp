@@ -0,0 +1,55 @@
+/*
+ * File: Sketch.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the QuantileSketch class, a streaming summary of a distribution that never stores the samples.
+ * Moments are kept with Welford's update, and quantiles with logarithmic buckets: a sample x != 0 is counted in
+ * bucket ceil(log|x| / log(gamma)) of the store of its sign, with gamma = (1 + accuracy) / (1 - accuracy), so every
+ * quantile is returned with a relative error of at most accuracy, whatever the number of samples. Sketches built on
+ * separate threads merge exactly, which lets every parallel chunk keep its own sketch.
+ */
+
+#ifndef SKETCH_HPP
+#define SKETCH_HPP
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+
+class QuantileSketch
+{
+private:
+    double accuracy; // Relative accuracy of the quantiles
+    double logGamma; // Logarithm of the bucket growth factor
+    std::map<int, std::uint64_t> positive; // Counts of positive samples per bucket
+    std::map<int, std::uint64_t> negative; // Counts of negative samples per bucket of |x|
+    std::uint64_t zeros; // Samples too small to bucket
+    std::uint64_t n; // Number of samples
+    double average; // Running mean
+    double squares; // Running sum of squared deviations from the mean
+    double lowest; // Smallest sample
+    double highest; // Largest sample
+
+    int bucket(double magnitude) const; // Bucket of a positive magnitude
+    double representative(int index) const; // Value returned for a bucket (relative error at most accuracy)
+
+public:
+    static constexpr double minMagnitude = 1e-12; // Samples with a smaller magnitude count as zero
+
+    QuantileSketch(double accuracy = 0.01); // Constructor
+
+    void add(double x); // Record one sample (must be finite)
+    void merge(const QuantileSketch& other); // Add every sample recorded by other
+
+    std::uint64_t count() const; // Number of samples
+    double mean() const; // Sample mean
+    double stdev() const; // Sample standard deviation
+    double min() const; // Smallest sample
+    double max() const; // Largest sample
+    double quantile(double q) const; // Value below which a fraction q of the samples lie
+    double tailMean(double q) const; // Mean of the lowest fraction q of the samples (expected shortfall of a P&L)
+};
+
+#endif // SKETCH_HPP
\ No newline at end of file
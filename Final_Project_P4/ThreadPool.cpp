@@ -0,0 +1,347 @@
+/*
+ * File: ThreadPool.cpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file implements the ThreadPool and TaskGroup classes. Workers block on a condition variable while the queue
+ * is empty. Waiting threads never simply block: TaskGroup::wait() keeps taking tasks from the shared queue and only
+ * sleeps briefly when there is nothing to run, so a chain of nested parallel loops always makes progress.
+ * Pending tasks are kept in two ordered maps, one by urgency and one by arrival, so that both the most urgent and
+ * the oldest task can be found in logarithmic time.
+ * Thread pinning uses SetThreadAffinityMask on Windows and pthread_setaffinity_np on Linux, and is a no-op elsewhere.
+ */
+
+#include "ThreadPool.hpp"
+#include <chrono>
+#include <limits>
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+static std::mutex configMutex; // Protects the settings below
+static std::size_t configThreads = 0; // Requested thread count (0 = one per hardware thread)
+static PinningPolicy configPolicy = PinningPolicy::None; // Requested pinning policy
+static bool started = false; // Set once the pool has been created
+static thread_local Schedule currentSchedule; // Schedule of the task running on this thread
+
+Schedule::Schedule(int priority, std::chrono::steady_clock::time_point deadline) : priority(priority), deadline(deadline)
+{
+}
+
+bool Schedule::atLeastAsUrgent(const Schedule& other) const
+{
+    return priority != other.priority ? priority > other.priority : deadline <= other.deadline;
+}
+
+Schedule Schedule::current()
+{
+    return currentSchedule;
+}
+
+ScheduleScope::ScheduleScope(const Schedule& schedule) : previous(currentSchedule)
+{
+    currentSchedule = schedule;
+}
+
+ScheduleScope::~ScheduleScope()
+{
+    currentSchedule = previous;
+}
+
+bool ThreadPool::Rank::operator<(const Rank& other) const
+{
+    if (priority != other.priority)
+    {
+        return priority > other.priority; // Higher priority first
+    }
+    if (deadline != other.deadline)
+    {
+        return deadline < other.deadline;
+    }
+    return sequence < other.sequence;
+}
+
+ThreadPool& ThreadPool::instance()
+{
+    static ThreadPool pool = []()
+    {
+        std::lock_guard<std::mutex> lock(configMutex);
+        started = true;
+        std::size_t threads = configThreads ? configThreads : std::thread::hardware_concurrency();
+        return ThreadPool(threads ? threads : 1, configPolicy);
+    }(); // Thread-safe lazy initialisation
+    return pool;
+}
+
+void ThreadPool::configure(std::size_t threads, PinningPolicy policy)
+{
+    std::lock_guard<std::mutex> lock(configMutex);
+    if (started)
+    {
+        throw std::logic_error("ThreadPool::configure must be called before the pool is first used.");
+    }
+    configThreads = threads;
+    configPolicy = policy;
+}
+
+ThreadPool::ThreadPool(std::size_t threads, PinningPolicy policy)
+    : sequence(0), dispatches(0), starvationLimit(std::chrono::milliseconds(100)), stopping(false)
+{
+    workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i, policy);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::workerLoop(std::size_t index, PinningPolicy policy)
+{
+    if (policy == PinningPolicy::Compact)
+    {
+        pinCurrentThread(index);
+    }
+
+    for (;;)
+    {
+        Entry entry;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+            {
+                return; // Stopping and nothing left to do
+            }
+            entry = takeTask();
+        }
+        runEntry(entry);
+    }
+}
+
+ThreadPool::Entry ThreadPool::takeTask()
+{
+    auto oldest = arrivals.begin();
+    auto next = tasks.begin(); // Most urgent task
+    if (++dispatches % starvationShare == 0 && std::chrono::steady_clock::now() - tasks.at(oldest->second).queued > starvationLimit)
+    {
+        next = tasks.find(oldest->second); // Starvation protection: give this turn to the oldest task
+    }
+    Entry entry = std::move(next->second);
+    arrivals.erase(next->first.sequence);
+    tasks.erase(next);
+    return entry;
+}
+
+void ThreadPool::runEntry(Entry& entry)
+{
+    ScheduleScope scope(entry.schedule); // Tasks queued by this task inherit its schedule
+    entry.task();
+}
+
+void ThreadPool::pinCurrentThread(std::size_t index)
+{
+    std::size_t cores = std::thread::hardware_concurrency();
+    if (cores == 0)
+    {
+        return;
+    }
+    std::size_t core = index % cores;
+#if defined(_WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+std::size_t ThreadPool::size() const
+{
+    return workers.size();
+}
+
+void ThreadPool::setStarvationLimit(std::chrono::steady_clock::duration limit)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    starvationLimit = limit;
+}
+
+void ThreadPool::enqueue(std::function<void()> task, const Schedule& schedule)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Rank rank{ schedule.priority, schedule.deadline, sequence++ };
+        tasks.emplace(rank, Entry{ std::move(task), schedule, std::chrono::steady_clock::now() });
+        arrivals.emplace(rank.sequence, rank);
+    }
+    available.notify_one();
+}
+
+bool ThreadPool::runPendingTask()
+{
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty())
+        {
+            return false;
+        }
+        entry = takeTask();
+    }
+    runEntry(entry);
+    return true;
+}
+
+bool ThreadPool::runPendingTask(const Schedule& floor)
+{
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty() || !tasks.begin()->second.schedule.atLeastAsUrgent(floor))
+        {
+            return false; // Nothing urgent enough: starvation protection is left to the workers
+        }
+        entry = std::move(tasks.begin()->second);
+        arrivals.erase(tasks.begin()->first.sequence);
+        tasks.erase(tasks.begin());
+    }
+    runEntry(entry);
+    return true;
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& body)
+{
+    if (count == 1)
+    {
+        body(0); // Nothing to parallelise: stay on the calling thread
+        return;
+    }
+    TaskGroup group(*this);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        group.run([&body, i]() { body(i); });
+    }
+    group.wait();
+}
+
+void ThreadPool::parallelSum(std::size_t count, std::size_t width, const std::function<void(std::size_t, double*)>& body, double* sums)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    std::vector<double> partial(count * width, 0.0); // Sums of each task
+    parallelFor(count, [&](std::size_t i) { body(i, &partial[i * width]); });
+
+    for (std::size_t stride = 1; stride < count; stride *= 2) // Level by level: task i absorbs task i + stride
+    {
+        for (std::size_t i = 0; i + stride < count; i += 2 * stride)
+        {
+            for (std::size_t k = 0; k < width; ++k)
+            {
+                partial[i * width + k] += partial[(i + stride) * width + k];
+            }
+        }
+    }
+    for (std::size_t k = 0; k < width; ++k)
+    {
+        sums[k] += partial[k];
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : pool(pool), pending(0), floor(std::numeric_limits<int>::max(), std::chrono::steady_clock::time_point::min()) // Most urgent possible
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    try
+    {
+        wait(); // Tasks reference this group, so it must not disappear before they finish
+    }
+    catch (...)
+    {
+    }
+}
+
+void TaskGroup::run(std::function<void()> task, const Schedule& schedule)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++pending;
+        if (floor.atLeastAsUrgent(schedule))
+        {
+            floor = schedule;
+        }
+    }
+    pool.enqueue([this, task = std::move(task)]()
+    {
+        std::exception_ptr caught;
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            caught = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (caught && !error)
+        {
+            error = caught; // Keep only the first error
+        }
+        --pending;
+        finished.notify_all();
+    }, schedule);
+}
+
+void TaskGroup::wait()
+{
+    for (;;)
+    {
+        Schedule limit = Schedule::current(); // Help with nothing less urgent than the waiter and every task of the group
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (pending == 0)
+            {
+                break;
+            }
+            if (limit.atLeastAsUrgent(floor))
+            {
+                limit = floor; // The group's own tasks always qualify, so nested waits cannot deadlock
+            }
+        }
+        if (!pool.runPendingTask(limit)) // Help instead of blocking a worker
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait_for(lock, std::chrono::microseconds(200), [this]() { return pending == 0; }); // Re-check the queue periodically
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (error)
+    {
+        std::rethrow_exception(std::exchange(error, nullptr));
+    }
+}
\ No newline at end of file
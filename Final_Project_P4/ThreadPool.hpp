@@ -0,0 +1,158 @@
+/*
+ * File: ThreadPool.hpp
+ * Author: Yumin Wu
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This file defines the ThreadPool class, a persistent process-wide pool of worker threads shared by every solver,
+ * and the TaskGroup class used to wait for a batch of tasks. The pool is started lazily on first use with a fixed
+ * thread count and an optional pinning policy, so no simulation ever pays for creating threads.
+ * A thread waiting on a TaskGroup executes queued tasks while it waits, which makes nested submission (a pool task
+ * that itself runs a parallel loop) safe from deadlock even when every worker is busy. A waiting thread only helps
+ * with tasks at least as urgent as itself and the group it waits for, so an urgent group never picks up a batch
+ * chunk while its own tasks are in flight; with nothing that urgent queued it blocks until the group finishes.
+ * Every task carries a Schedule (priority and deadline). Workers always take the most urgent task: higher priority
+ * first, then earlier deadline, then first come first served. Solvers queue one task per path chunk, so a long job
+ * yields the pool to more urgent work at every chunk boundary. Tasks queued from inside a task inherit its Schedule,
+ * and one dispatch in starvationShare goes to the oldest task if it has waited longer than the starvation limit, so
+ * batch work keeps progressing under a steady stream of urgent work.
+ * parallelSum() adds the partial sums of its tasks along a binary tree whose shape depends only on the number of
+ * tasks, so a sum comes out bit for bit the same whatever the number of threads or the order the tasks finish in.
+ */
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+enum class PinningPolicy
+{
+    None,   // Let the operating system schedule the workers
+    Compact // Pin worker i to logical core i
+};
+
+struct Schedule
+{
+    int priority; // Higher priorities run first (for example 10 for quotes, 0 by default, -10 for overnight batches)
+    std::chrono::steady_clock::time_point deadline; // Earlier deadlines run first within a priority
+
+    Schedule(int priority = 0, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max()); // Constructor
+    bool atLeastAsUrgent(const Schedule& other) const; // Higher priority, or the same priority and a deadline no later
+    static Schedule current(); // Schedule of the task running on the calling thread (the default outside the pool)
+};
+
+class ScheduleScope
+{
+private:
+    Schedule previous; // Schedule restored on destruction
+
+public:
+    explicit ScheduleScope(const Schedule& schedule); // Tasks queued from this thread inherit schedule until destruction
+    ~ScheduleScope();
+    ScheduleScope(const ScheduleScope&) = delete;
+    ScheduleScope& operator=(const ScheduleScope&) = delete;
+};
+
+class ThreadPool
+{
+private:
+    struct Rank
+    {
+        int priority; // Higher priorities are more urgent (compared directly, never negated)
+        std::chrono::steady_clock::time_point deadline; // Earlier deadline is more urgent
+        std::uint64_t sequence; // Arrival order breaks ties
+
+        bool operator<(const Rank& other) const;
+    };
+
+    struct Entry
+    {
+        std::function<void()> task; // Work to run
+        Schedule schedule; // Inherited by tasks the work queues itself
+        std::chrono::steady_clock::time_point queued; // Arrival time, for starvation protection
+    };
+
+    std::vector<std::thread> workers; // Worker threads, started once and kept for the lifetime of the process
+    std::map<Rank, Entry> tasks; // Pending tasks, most urgent first
+    std::map<std::uint64_t, Rank> arrivals; // Pending tasks, oldest first
+    std::uint64_t sequence; // Arrival counter
+    std::uint64_t dispatches; // Dispatch counter
+    std::chrono::steady_clock::duration starvationLimit; // Wait after which a task may run regardless of priority
+    std::mutex mutex; // Protects every member above and stopping
+    std::condition_variable available; // Signalled when a task is queued or the pool stops
+    bool stopping; // Set by the destructor
+
+    ThreadPool(std::size_t threads, PinningPolicy policy); // Constructor, only called by instance()
+    void workerLoop(std::size_t index, PinningPolicy policy); // Body of each worker thread
+    Entry takeTask(); // Remove the next task to run (mutex held, queue not empty)
+    static void runEntry(Entry& entry); // Run a task under its own Schedule
+    static void pinCurrentThread(std::size_t index); // Bind the calling thread to one logical core
+
+public:
+    static constexpr std::uint64_t starvationShare = 8; // One dispatch in this many may serve a starving task
+
+    static ThreadPool& instance(); // The process-wide pool, started on first call
+    static void configure(std::size_t threads, PinningPolicy policy); // Must be called before the first instance()
+
+    ~ThreadPool(); // Finish queued tasks and join the workers
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const; // Number of worker threads
+    void setStarvationLimit(std::chrono::steady_clock::duration limit); // Change the starvation limit (100 ms by default)
+    void enqueue(std::function<void()> task, const Schedule& schedule = Schedule::current()); // Queue a task for any worker
+    bool runPendingTask(); // Run the most urgent queued task on the calling thread; false if the queue was empty
+    bool runPendingTask(const Schedule& floor); // Same, but only a task at least as urgent as floor; false if there is none
+
+    template <typename F>
+    auto submit(F f, const Schedule& schedule = Schedule::current()) -> std::future<decltype(f())>; // Queue a task and return a future for its result
+
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& body); // Run body(0..count) on the pool and wait
+    // Run body(i, partial) for i in 0..count on the pool, each adding width sums to its own zeroed partial, and add the
+    // partials to sums pairwise in a fixed tree order
+    void parallelSum(std::size_t count, std::size_t width, const std::function<void(std::size_t, double*)>& body, double* sums);
+};
+
+class TaskGroup
+{
+private:
+    ThreadPool& pool; // Pool the tasks are queued on
+    std::size_t pending; // Tasks queued but not yet finished
+    std::exception_ptr error; // First exception thrown by a task
+    Schedule floor; // Least urgent schedule of the tasks queued so far
+    std::mutex mutex; // Protects pending and error
+    std::condition_variable finished; // Signalled when a task completes
+
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::instance()); // Constructor
+    ~TaskGroup(); // Waits for outstanding tasks (exceptions are swallowed here; call wait() to observe them)
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task, const Schedule& schedule = Schedule::current()); // Queue a task belonging to this group
+    void wait(); // Help run queued tasks until every task of the group is done, then rethrow the first error
+};
+
+template <typename F>
+auto ThreadPool::submit(F f, const Schedule& schedule) -> std::future<decltype(f())>
+{
+    auto task = std::make_shared<std::packaged_task<decltype(f())()>>(std::move(f)); // std::function needs a copyable target
+    std::future<decltype(f())> result = task->get_future();
+    enqueue([task]() { (*task)(); }, schedule);
+    return result;
+}
+
+#endif // THREADPOOL_HPP
\ No newline at end of file
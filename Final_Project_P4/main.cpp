@@ -7,21 +7,45 @@
  * This file serves as the entry point for the Monte Carlo simulation program. It tests various configurations
  * of the simulation, including different option types, FDM (Finite Difference Method) schemes, and SDE (Stochastic Differential Equation) models.
  * The program uses the SimulationBuilder and MCMediator classes to configure and run the simulations, and it measures the execution time
- * using the StopWatch class. The main function calls three test functions: testDifferentOptions, testDifferentFDM, and testDifferentSDE,
- * which demonstrate the flexibility and capabilities of the simulation framework.
+ * using the StopWatch class. The main function calls the test functions testDifferentOptions, testDifferentFDM, testDifferentSDE
+ * testJobFusion, testLiborMarketModel, testBermudanBounds, testForwardGreeks, testMalliavinGreeks, testDeltaHedging, testBoundaryPolicies, testKernelDispatch, testFourierPricer, testLatticePricer, testMomentMatching, testPathCache and testReproducibility, which demonstrate the flexibility and capabilities of the simulation framework.
  */
 
+#include <iomanip>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
 #include "SimulationBuilder.hpp"
 #include "MCMediator.hpp"
+#include "SimulationQueue.hpp"
+#include "LMM.hpp"
+#include "Bermudan.hpp"
+#include "Greeks.hpp"
+#include "Malliavin.hpp"
+#include "Hedging.hpp"
+#include "Dispatch.hpp"
+#include "Fourier.hpp"
+#include "Lattice.hpp"
+#include "PathCache.hpp"
 #include "StopWatch.hpp"  // Include StopWatch header for timing
 
  // Forward declarations of test functions
 void testDifferentOptions(); // Test different option types
 void testDifferentFDM();     // Test different FDM schemes
 void testDifferentSDE();     // Test different SDE models
+void testJobFusion();        // Test fusing compatible jobs into one simulation
+void testLiborMarketModel(); // Test the LIBOR market model engine
+void testBermudanBounds();   // Test lower and dual upper bounds of a Bermudan option
+void testForwardGreeks();    // Test forward-mode pathwise Greeks
+void testMalliavinGreeks();  // Test Malliavin-weight Greeks of discontinuous payoffs
+void testDeltaHedging();     // Test the delta-hedging backtest
+void testBoundaryPolicies(); // Test the boundary policies for negative prices
+void testKernelDispatch();   // Test the batch kernels of every supported instruction set
+void testFourierPricer();    // Test the Fourier pricer and its use as a control variate
+void testLatticePricer();    // Test the binomial and trinomial lattice pricers
+void testMomentMatching();   // Test moment-matched normals and batched standard errors
+void testPathCache();        // Test sharing simulated paths through the shared-memory cache
+void testReproducibility();  // Test that a price does not depend on the paths simulated alongside it
 
 // Global variables for simulation parameters
 double S0 = 100.0;  // Initial stock price
@@ -41,6 +65,19 @@ int main()
         testDifferentOptions(); // Test different option types
         testDifferentFDM();     // Test different FDM schemes
         testDifferentSDE();     // Test different SDE models
+        testJobFusion();        // Test fusing compatible jobs into one simulation
+        testLiborMarketModel(); // Test the LIBOR market model engine
+        testBermudanBounds();   // Test lower and dual upper bounds of a Bermudan option
+        testForwardGreeks();    // Test forward-mode pathwise Greeks
+        testMalliavinGreeks();  // Test Malliavin-weight Greeks of discontinuous payoffs
+        testDeltaHedging();     // Test the delta-hedging backtest
+        testBoundaryPolicies(); // Test the boundary policies for negative prices
+        testKernelDispatch();   // Test the batch kernels of every supported instruction set
+        testFourierPricer();    // Test the Fourier pricer and its use as a control variate
+        testLatticePricer();    // Test the binomial and trinomial lattice pricers
+        testMomentMatching();   // Test moment-matched normals and batched standard errors
+        testPathCache();        // Test sharing simulated paths through the shared-memory cache
+        testReproducibility();  // Test that a price does not depend on the paths simulated alongside it
     }
     catch (const std::exception& e)
     {
@@ -92,7 +129,7 @@ void testDifferentOptions()
         .setSDE(std::make_shared<GBM>(r, sigma))                // Set GBM SDE
         .setFDM(std::make_shared<EulerMethod>(std::make_shared<GBM>(r, sigma))) // Set Euler FDM
         .setRNG(std::make_shared<MersenneTwister>())                            // Set Mersenne Twister RNG
-        .setPayoff(std::make_shared<BarrierOption>(K, B, true, false, true));   // Set Down-and-In Call payoff
+        .setPayoff(std::make_shared<BarrierOption<true, false, true>>(K, B));   // Set Down-and-In Call payoff
     auto mediator3 = std::make_shared<MCMediator>(builder3);                    // Create mediator
     double price3 = mediator3->runSimulation();                                 // Run simulation
     stopWatch.StopStopWatch();                                                  // Stop timer
@@ -108,7 +145,7 @@ void testDifferentOptions()
         .setSDE(std::make_shared<GBM>(r, sigma))                                // Set GBM SDE
         .setFDM(std::make_shared<EulerMethod>(std::make_shared<GBM>(r, sigma))) // Set Euler FDM
         .setRNG(std::make_shared<MersenneTwister>())                            // Set Mersenne Twister RNG
-        .setPayoff(std::make_shared<BarrierOption>(K, B, false, true, false));  // Set Up-and-Out Put payoff
+        .setPayoff(std::make_shared<BarrierOption<false, true, false>>(K, B));  // Set Up-and-Out Put payoff
     auto mediator4 = std::make_shared<MCMediator>(builder4);                    // Create mediator
     double price4 = mediator4->runSimulation();                                 // Run simulation
     stopWatch.StopStopWatch();                                                  // Stop timer
@@ -154,6 +191,22 @@ void testDifferentFDM()
     std::cout << "European Call Price (Milstein Method): " << price2 << std::endl;
     std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
     std::cout << std::endl;
+
+    // Price European Call by sampling the exact lognormal law at maturity only
+    stopWatch.Reset(); // Reset timer
+    stopWatch.StartStopWatch(); // Start timer
+    auto builder3 = std::make_shared<SimulationBuilder>();
+    builder3->setInitialCondition(S0, T, N, M)              // Set initial conditions
+        .setSDE(std::make_shared<GBM>(r, sigma))            // Set GBM SDE
+        .setFDM(std::make_shared<ExactTransition>(std::make_shared<GBM>(r, sigma))) // Opt in to exact sampling of the observation dates
+        .setRNG(std::make_shared<MersenneTwister>())        // Set Mersenne Twister RNG
+        .setPayoff(std::make_shared<EuropeanCall>(K));      // Set European Call payoff
+    auto mediator3 = std::make_shared<MCMediator>(builder3); // Create mediator
+    double price3 = mediator3->runSimulation();             // Run simulation
+    stopWatch.StopStopWatch();                              // Stop timer
+    std::cout << "European Call Price (Exact Transition): " << price3 << std::endl;
+    std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+    std::cout << std::endl;
 }
 
 // Test different SDE models
@@ -209,4 +262,384 @@ void testDifferentSDE()
     std::cout << "Asian Put Price (CEV): " << price3 << std::endl;
     std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
     std::cout << std::endl;
+}
+
+// Test fusing jobs that share SDE, FDM, S0, T and N
+void testJobFusion()
+{
+    std::cout << "Testing job fusion..." << std::endl;
+
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    SimulationQueue queue;                                  // Queue that fuses compatible jobs
+
+    stopWatch.StartStopWatch();                             // Start timer
+    std::shared_ptr<Payoff> payoffs[] = {
+        std::make_shared<EuropeanCall>(K),                  // European Call
+        std::make_shared<EuropeanPut>(K),                   // European Put
+        std::make_shared<AsianOption>(K, false)             // Asian Put
+    };
+    std::vector<std::future<double>> prices;
+    for (const auto& payoff : payoffs)
+    {
+        auto builder = std::make_shared<SimulationBuilder>();
+        builder->setInitialCondition(S0, T, N, M)           // Same initial conditions for every job
+            .setSDE(std::make_shared<GBM>(r, sigma))        // Separate but identical GBM objects
+            .setFDM(std::make_shared<EulerMethod>(std::make_shared<GBM>(r, sigma))) // Set Euler FDM
+            .setRNG(std::make_shared<MersenneTwister>())    // Set Mersenne Twister RNG
+            .setPayoff(payoff);                             // Only the payoff differs
+        prices.push_back(queue.enqueue(builder));           // Queue the job
+    }
+    std::size_t simulations = queue.flush();                // Run the queued jobs
+    stopWatch.StopStopWatch();                              // Stop timer
+    std::cout << "Jobs: " << prices.size() << ", fused simulations: " << simulations << std::endl;
+    std::cout << "European Call Price: " << prices[0].get() << std::endl;
+    std::cout << "European Put Price: " << prices[1].get() << std::endl;
+    std::cout << "Asian Put Price: " << prices[2].get() << std::endl;
+    std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+    std::cout << std::endl;
+}
+
+// Test the LIBOR market model engine
+void testLiborMarketModel()
+{
+    std::cout << "Testing LIBOR market model..." << std::endl;
+
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    std::size_t rates = 40;                                 // Quarterly forward rates over 10 years
+    auto model = std::make_shared<LiborMarketModel>(0.25, std::vector<double>(rates, 0.05), std::vector<double>(rates, 0.2), 0.1, 3); // 3 factors
+    std::vector<std::shared_ptr<LMMPayoff>> payoffs = {
+        std::make_shared<Cap>(0.05, 1, rates),              // 10-year cap
+        std::make_shared<Swaption>(0.05, 8, 28, true),      // 2y x 5y payer swaption
+        std::make_shared<Swaption>(0.05, 8, 28, false)      // 2y x 5y receiver swaption
+    };
+
+    stopWatch.StartStopWatch();                             // Start timer
+    std::vector<double> prices = LMMSolver(model, std::make_shared<MersenneTwister>(), 1, M).solve(payoffs);
+    stopWatch.StopStopWatch();                              // Stop timer
+    std::cout << "Cap Price: " << prices[0] << std::endl;
+    std::cout << "Payer Swaption Price: " << prices[1] << std::endl;
+    std::cout << "Receiver Swaption Price: " << prices[2] << std::endl;
+    std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+    std::cout << std::endl;
+}
+
+// Test lower and dual upper bounds of a Bermudan option
+void testBermudanBounds()
+{
+    std::cout << "Testing Bermudan price bounds..." << std::endl;
+
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    std::vector<double> dates;                              // Ten exercise dates up to maturity
+    for (int k = 1; k <= 10; ++k)
+    {
+        dates.push_back(T * k / 10);
+    }
+    auto gbm = std::make_shared<GBM>(r, sigma);
+    BermudanSolver solver(gbm, std::make_shared<EulerMethod>(gbm), std::make_shared<MersenneTwister>(),
+        std::make_shared<EuropeanPut>(K), S0, r, dates);   // Bermudan put exercisable on the dates
+
+    stopWatch.StartStopWatch();                             // Start timer
+    DualBounds bounds = solver.solve(M, M, 1000);           // Train, lower bound, and 1000 outer paths for the upper bound
+    stopWatch.StopStopWatch();                              // Stop timer
+    std::cout << "Bermudan Put Lower Bound: " << bounds.lower << " (std. error " << bounds.lowerError << ")" << std::endl;
+    std::cout << "Bermudan Put Upper Bound: " << bounds.upper << " (std. error " << bounds.upperError << ")" << std::endl;
+    std::cout << "Average inner paths per node: " << bounds.innerPaths << std::endl;
+    std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+    std::cout << std::endl;
+}
+
+// Test forward-mode pathwise Greeks
+void testForwardGreeks()
+{
+    std::cout << "Testing forward-mode Greeks..." << std::endl;
+
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    GBM gbm(r, sigma);
+    EuropeanCall call(K);
+    std::array<int, 3> inputs = { -1, 1, 0 };               // Lanes: S0 (delta), sigma (vega), mu (rho of the undiscounted payoff)
+
+    stopWatch.StartStopWatch();                             // Start timer
+    ForwardGreeks<3> greeks = forwardGreeks<EulerMethod>(gbm, call, std::make_shared<MersenneTwister>(), S0, T, N, M, inputs);
+    stopWatch.StopStopWatch();                              // Stop timer
+    std::cout << "European Call Payoff: " << greeks.price << std::endl;
+    std::cout << "Delta: " << greeks.sensitivities[0] << std::endl;
+    std::cout << "Vega: " << greeks.sensitivities[1] << std::endl;
+    std::cout << "Drift Sensitivity: " << greeks.sensitivities[2] << std::endl;
+    std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+    std::cout << std::endl;
+}
+
+// Test Malliavin-weight Greeks of discontinuous payoffs
+void testMalliavinGreeks()
+{
+    std::cout << "Testing Malliavin-weight Greeks..." << std::endl;
+
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    auto gbm = std::make_shared<GBM>(r, sigma);
+    std::vector<std::pair<std::string, std::shared_ptr<Payoff>>> payoffs = {
+        { "Digital Call", std::make_shared<DigitalOption>(K, true) },
+        { "Down-and-In Put", std::make_shared<BarrierOption<false, false, true>>(K, 90.0) }
+    };
+
+    for (const auto& [name, payoff] : payoffs)
+    {
+        stopWatch.StartStopWatch();                         // Start timer
+        WeightedGreeks greeks = MalliavinSolver(gbm, std::make_shared<MersenneTwister>(), payoff, S0, T, 100, M).solve();
+        stopWatch.StopStopWatch();                          // Stop timer
+        std::cout << name << " Payoff: " << greeks.price << " (std. error " << greeks.priceError << ")" << std::endl;
+        std::cout << name << " Delta: " << greeks.delta << " (std. error " << greeks.deltaError << ")" << std::endl;
+        std::cout << name << " Vega: " << greeks.vega << " (std. error " << greeks.vegaError << ")" << std::endl;
+        std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+        stopWatch.Reset();                                  // Reset timer for the next payoff
+    }
+    std::cout << std::endl;
+}
+
+// Test the delta-hedging backtest
+void testDeltaHedging()
+{
+    std::cout << "Testing delta hedging..." << std::endl;
+
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    int rebalances = 52;                                    // Weekly rebalancing
+    auto market = std::make_shared<GBM>(0.1, sigma);        // Real-world drift differs from the rate
+    auto pricing = std::make_shared<GBM>(r, sigma);         // Risk-neutral model of the hedger
+    auto call = std::make_shared<EuropeanCall>(K);
+    std::vector<std::pair<std::string, std::shared_ptr<HedgeRatio>>> hedges = {
+        { "Black-Scholes Delta", std::make_shared<BlackScholesHedge>(K, r, sigma, T, true) },
+        { "Regression Delta", std::make_shared<RegressionHedge>(pricing, std::make_shared<EulerMethod>(pricing),
+            std::make_shared<MersenneTwister>(), call, S0, r, T, rebalances, M) }
+    };
+
+    for (const auto& [name, hedge] : hedges)
+    {
+        stopWatch.StartStopWatch();                         // Start timer
+        HedgeReport report = HedgeSimulator(market, std::make_shared<EulerMethod>(market), std::make_shared<MersenneTwister>(), call, hedge,
+            S0, r, T, rebalances, M, 0.001).solve();        // 10 bp transaction costs
+        stopWatch.StopStopWatch();                          // Stop timer
+        std::cout << name << " Premium: " << report.premium << std::endl;
+        std::cout << name << " P&L Mean: " << report.pnl.mean() << ", Std. Dev.: " << report.pnl.stdev() << std::endl;
+        std::cout << name << " P&L 1% Quantile: " << report.pnl.quantile(0.01) << ", 1% Expected Shortfall: " << report.pnl.tailMean(0.01) << std::endl;
+        std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+        stopWatch.Reset();                                  // Reset timer for the next hedge
+    }
+    std::cout << std::endl;
+}
+
+// Test the boundary policies on a coarse CEV grid, where Euler steps regularly land below zero
+void testBoundaryPolicies()
+{
+    std::cout << "Testing boundary policies..." << std::endl;
+
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    std::vector<std::pair<std::string, Boundary>> policies = {
+        { "Absorb", Boundary::Absorb }, { "Reflect", Boundary::Reflect },
+        { "Truncate", Boundary::Truncate }, { "Reject", Boundary::Reject }
+    };
+
+    for (const auto& [name, policy] : policies)
+    {
+        auto cev = std::make_shared<CEV>(r, 3.0, 0.8);      // High volatility of volatility makes negative steps common
+        cev->setBoundary(policy);
+        stopWatch.StartStopWatch();                         // Start timer
+        double price = MCSolver({ cev, std::make_shared<EulerMethod>(cev), std::make_shared<MersenneTwister>(),
+            std::make_shared<EuropeanPut>(K), S0, T, 12, M }).solve(); // Monthly steps
+        stopWatch.StopStopWatch();                          // Stop timer
+        std::cout << name << " CEV Put Price: " << price << ", Steps Below Zero: " << cev->boundaryHits()
+            << ", Rejected Paths: " << cev->rejectedPaths() << std::endl;
+        std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+        stopWatch.Reset();                                  // Reset timer for the next policy
+    }
+    std::cout << std::endl;
+}
+
+// Test the batch kernels of every instruction set the host supports on the same simulation
+void testKernelDispatch()
+{
+    std::cout << "Testing runtime kernel dispatch..." << std::endl;
+    std::cout << "Detected Instruction Set: " << kernels().name << std::endl;
+
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    Isa widest = kernels().isa;
+    auto cev = std::make_shared<CEV>(r, 0.5, 0.8);          // No exact transition: every step, scale and boundary kernel runs on the full grid
+    double first = 0.0;
+    for (Isa isa : supportedIsas())
+    {
+        selectKernels(isa);
+        stopWatch.StartStopWatch();                         // Start timer
+        double price = MCSolver({ cev, std::make_shared<MilsteinMethod>(cev), std::make_shared<MersenneTwister>(42),
+            std::make_shared<BarrierOption<true, true, false>>(K, 130.0), S0, T, N, M }).solve();
+        stopWatch.StopStopWatch();                          // Stop timer
+        if (isa == supportedIsas().front())
+        {
+            first = price;
+        }
+        std::cout << kernels().name << " CEV Up-and-Out Call Price: " << std::setprecision(17) << price << std::setprecision(6)
+            << (price == first ? " (identical to the first table)" : " (differs from the first table)") << std::endl;
+        std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+        stopWatch.Reset();                                  // Reset timer for the next instruction set
+    }
+    selectKernels(widest);                                  // Restore the detected choice
+    std::cout << std::endl;
+}
+
+// Test COS strips against Carr-Madan and Monte Carlo, and the Fourier fast path and control variate of the mediator
+void testFourierPricer()
+{
+    std::cout << "Testing the Fourier pricer..." << std::endl;
+
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    std::vector<std::pair<std::string, std::shared_ptr<SDE>>> models = {
+        { "GBM", std::make_shared<GBM>(r, sigma) },
+        { "Heston", std::make_shared<Heston>(r, 1.5, 0.04, 0.5, -0.7, 0.04) },
+        { "Merton", std::make_shared<MertonJumpDiffusion>(r, 0.15, 0.5, -0.1, 0.15) },
+        { "Variance Gamma", std::make_shared<VarianceGamma>(r, 0.2, 0.3, -0.1) }
+    };
+    std::vector<double> strikes;
+    for (int k = 0; k < 100; ++k)
+    {
+        strikes.push_back(50.0 + k); // Strip of 100 strikes
+    }
+
+    for (const auto& [name, sde] : models)
+    {
+        stopWatch.StartStopWatch();                         // Start timer
+        FourierPricer pricer(sde, S0, T);
+        std::vector<double> calls = pricer.prices(strikes, true);
+        stopWatch.StopStopWatch();                          // Stop timer
+        std::vector<double> gridStrikes, gridCalls;
+        pricer.strikeGrid(gridStrikes, gridCalls);
+        std::size_t atm = gridStrikes.size() / 2;           // The grid is centred on S0
+        double mc = MCSolver({ sde, std::make_shared<EulerMethod>(sde), std::make_shared<MersenneTwister>(42), // The scheme steps the model under test
+            std::make_shared<EuropeanCall>(K), S0, T, N, M }).solve();
+        std::cout << name << " ATM Call: COS " << calls[50] << ", Carr-Madan " << gridCalls[atm] << ", Monte Carlo " << mc << std::endl;
+        std::cout << "Time taken for 100 strikes: " << stopWatch.GetTime() << " seconds" << std::endl;
+        stopWatch.Reset();                                  // Reset timer for the next model
+    }
+
+    for (bool fourier : { false, true })
+    {
+        auto builder = std::make_shared<SimulationBuilder>();
+        builder->setInitialCondition(S0, T, N, M)
+            .setSDE(std::make_shared<GBM>(r, sigma))
+            .setFDM(std::make_shared<EulerMethod>(std::make_shared<GBM>(r, sigma)))
+            .setRNG(std::make_shared<MersenneTwister>(42))
+            .setPayoff(std::make_shared<AsianOption>(K, true));
+        stopWatch.StartStopWatch();                         // Start timer
+        double price = MCMediator(builder, fourier).runSimulation();
+        stopWatch.StopStopWatch();                          // Stop timer
+        std::cout << "Asian Call Price (GBM" << (fourier ? ", European control variate" : "") << "): " << price << std::endl;
+        std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+        stopWatch.Reset();                                  // Reset timer
+    }
+    std::cout << std::endl;
+}
+
+// Test the lattice against the Fourier price, on an American put, and on a barrier option against Monte Carlo
+void testLatticePricer()
+{
+    std::cout << "Testing the lattice pricer..." << std::endl;
+
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    auto gbm = std::make_shared<GBM>(r, sigma);
+    LatticePricer trinomial(gbm, S0, T);
+    LatticePricer binomial(gbm, S0, T, LatticePricer::Tree::Binomial);
+    EuropeanCall call(K);
+    EuropeanPut put(K);
+    BarrierOption<true, true, false> upAndOut(K, 120.0);
+
+    std::cout << "European Call: Trinomial " << trinomial.extrapolated(call, false, N) << ", Binomial " << binomial.extrapolated(call, false, N)
+        << ", Fourier " << FourierPricer(gbm, S0, T).price(K, true) << std::endl;
+
+    stopWatch.StartStopWatch();                             // Start timer
+    double american = trinomial.extrapolated(put, true, N);
+    stopWatch.StopStopWatch();                              // Stop timer
+    std::cout << "American Put: Trinomial " << american << ", Binomial " << binomial.extrapolated(put, true, N)
+        << ", European " << trinomial.extrapolated(put, false, N) << std::endl;
+    std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+    stopWatch.Reset();                                      // Reset timer
+
+    double mc = MCSolver({ gbm, std::make_shared<EulerMethod>(gbm), std::make_shared<MersenneTwister>(42),
+        std::make_shared<BarrierOption<true, true, false>>(K, 120.0), S0, T, N, M }).solve(); // Monitored on the N steps only, so a little above the tree price
+    std::cout << "Up-and-Out Call (B = 120): Trinomial " << trinomial.extrapolated(upAndOut, false, N) << ", Monte Carlo " << mc << std::endl;
+    std::cout << std::endl;
+}
+
+// Test moment matching of the normals of every time step against plain sampling, with batched standard errors
+void testMomentMatching()
+{
+    std::cout << "Testing moment matching..." << std::endl;
+
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    auto gbm = std::make_shared<GBM>(r, sigma);
+    for (bool matched : { false, true })
+    {
+        std::shared_ptr<RNG> rng = std::make_shared<MersenneTwister>(42);
+        if (matched)
+        {
+            rng = std::make_shared<MomentMatchedRNG>(rng);
+        }
+        stopWatch.StartStopWatch();                         // Start timer
+        MCSolver solver({ gbm, std::make_shared<EulerMethod>(gbm), rng, std::make_shared<EuropeanCall>(K), S0, T, N, M });
+        double price = solver.solve();
+        stopWatch.StopStopWatch();                          // Stop timer
+        std::cout << (matched ? "Moment-Matched" : "Plain") << " European Call Price: " << price
+            << ", Standard Error: " << solver.standardError() << std::endl;
+        std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+        stopWatch.Reset();                                  // Reset timer
+    }
+    std::cout << std::endl;
+}
+
+// Test sharing simulated paths through the shared-memory cache
+void testPathCache()
+{
+    std::cout << "Testing the shared path cache..." << std::endl;
+
+#ifdef _WIN32
+    std::cout << "The shared path cache needs POSIX shared memory." << std::endl;
+#else
+    StopWatch stopWatch;                                    // Timer for measuring execution time
+    PathCache::remove("/mc_path_cache_test");               // Start from an empty cache
+    auto cache = std::make_shared<PathCache>("/mc_path_cache_test");
+    auto gbm = std::make_shared<GBM>(r, sigma);
+    for (int run = 1; run <= 2; ++run)                      // A second process with the same setup would hit like run 2
+    {
+        stopWatch.StartStopWatch();                         // Start timer
+        MCSolver solver({ gbm, std::make_shared<EulerMethod>(gbm), std::make_shared<MersenneTwister>(42),
+            std::make_shared<AsianOption>(K, true), S0, T, N, M });
+        solver.setPathCache(cache);
+        double price = solver.solve();
+        stopWatch.StopStopWatch();                          // Stop timer
+        std::cout << "Run " << run << " Asian Call Price: " << price << ", Cache Hits: " << cache->hits()
+            << ", Misses: " << cache->misses() << std::endl;
+        std::cout << "Time taken: " << stopWatch.GetTime() << " seconds" << std::endl;
+        stopWatch.Reset();                                  // Reset timer
+    }
+    PathCache::remove("/mc_path_cache_test");
+#endif
+    std::cout << std::endl;
+}
+
+// Test that a price does not depend on the paths simulated alongside it
+void testReproducibility()
+{
+    std::cout << "Testing reproducible mode..." << std::endl;
+
+    auto gbm = std::make_shared<GBM>(r, sigma);
+    auto call = std::make_shared<AsianOption>(K, true); // Observed at every step, so every block is stepped N times
+    auto solver = [&]()
+    {
+        return MCSolver({ gbm, std::make_shared<EulerMethod>(gbm), std::make_shared<MersenneTwister>(42), call, S0, T, N, M });
+    };
+    for (bool reproducible : { false, true })
+    {
+        MCSolver::setReproducible(reproducible);
+        double alone = solver().solve(std::vector<std::shared_ptr<Payoff>>{ call }, std::vector<int>{ M / 2 })[0];
+        double fused = solver().solve(std::vector<std::shared_ptr<Payoff>>{ call, call }, std::vector<int>{ M, M / 2 })[1]; // The same job fused with a larger one
+        std::cout << (reproducible ? "Reproducible" : "Default") << " mode: Alone " << std::setprecision(17) << alone
+            << ", Fused " << fused << (alone == fused ? " (identical)" : " (different)") << std::setprecision(6) << std::endl;
+    }
+    MCSolver::setReproducible(false);
+    std::cout << std::endl;
 }
\ No newline at end of file